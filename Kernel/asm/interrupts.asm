@@ -1,6 +1,8 @@
 
 GLOBAL _cli
 GLOBAL _sti
+GLOBAL _irqSave
+GLOBAL _irqRestore
 GLOBAL _hlt
 
 GLOBAL picMasterMask
@@ -8,7 +10,13 @@ GLOBAL picSlaveMask
 
 GLOBAL _irq00Handler
 GLOBAL _irq01Handler
+GLOBAL _apicTimerHandler
+GLOBAL _spuriousHandler
+GLOBAL _rescheduleHandler
 GLOBAL _irq80Handler
+GLOBAL _syscallHandler
+GLOBAL _irq81Handler
+GLOBAL _yield
 
 GLOBAL _exceptionHandler00
 GLOBAL _exceptionHandler06
@@ -18,8 +26,18 @@ GLOBAL register_snapshot_taken
 
 EXTERN irqDispatcher
 EXTERN syscallDispatcher
+EXTERN syscallDispatch
 EXTERN exceptionDispatcher
 EXTERN getStackBase
+EXTERN schedule
+EXTERN schedulerTick
+EXTERN apicInterruptEnd
+EXTERN exitFaultingProcess
+EXTERN kernelLock
+EXTERN kernelUnlock
+EXTERN kernelUnlockAll
+EXTERN finishSwitch
+EXTERN irq_eoi_register
 
 SECTION .text
 
@@ -63,16 +81,30 @@ SECTION .text
 	pop rax
 %endmacro
 
+; End of Interrupt: a store to the local APIC when the IO-APIC routes IRQs, the 8259 otherwise
+; Clobbers rax
+%macro signalEOI 0
+	mov rax, [irq_eoi_register]
+	test rax, rax
+	jz %%pic
+	mov dword [rax], 0
+	jmp %%done
+%%pic:
+	mov al, 20h
+	out 20h, al
+%%done:
+%endmacro
+
 %macro irqHandlerMaster 1
 	pushState
+	call kernelLock
 
 	mov rdi, %1 ; pass argument to irqDispatcher
 	call irqDispatcher
 
-	; signal pic EOI (End of Interrupt)
-	mov al, 20h
-	out 20h, al
+	signalEOI
 
+	call kernelUnlock
 	popState
 	iretq
 %endmacro
@@ -110,11 +142,15 @@ SECTION .text
 	mov rax, [rsp + 0x10] ; RFLAGS
 	mov [exception_register_snapshot + 0x88], rax
 
+	call kernelLock ; before the arguments: it clobbers rdi and rsi
+
 	mov rdi, %1 ; pass argument to exceptionDispatcher
 	mov rsi, exception_register_snapshot ;pass current register values to exceptionDispatcher
-	
 	call exceptionDispatcher
 
+	call exitFaultingProcess ; does not return unless the shell faulted
+	call kernelUnlockAll ; the shell starts over on a fresh stack
+
 	call getStackBase ; reset the stack
 	mov [rsp + 0x18], rax
 
@@ -137,6 +173,26 @@ _sti:
 	sti
 	ret
 
+; Returns RFLAGS as they were and disables interrupts
+_irqSave:
+	pushfq
+	pop rax
+	cli
+	ret
+
+; Enables interrupts again if the RFLAGS in rdi (from _irqSave) had them enabled
+_irqRestore:
+	test rdi, 0x200
+	jz .keep
+	sti
+.keep:
+	ret
+
+; Gives up the CPU through _irq81Handler, so the switch always goes through a full interrupt frame
+_yield:
+	int 0x81
+	ret
+
 picMasterMask:
 	push rbp     ; Stack frame
 	mov rbp, rsp
@@ -160,13 +216,69 @@ picSlaveMask:
 	ret
 
 ; 8254 Timer (Timer Tick)
+; Not using the %irqHandlerMaster macro because the scheduler may switch stacks before popping the frame
 _irq00Handler:
-	irqHandlerMaster 0
+	pushState
+	call kernelLock
+
+	mov rdi, 0 ; pass argument to irqDispatcher
+	call irqDispatcher
+
+	call kernelUnlock ; switching only takes the run queue locks, see kernelLock.h
+
+	mov rdi, rsp ; frame of the interrupted process
+	call schedulerTick
+	mov rsp, rax ; frame of the process to resume
+	call finishSwitch ; off the previous process' stack
+
+	signalEOI
+
+	popState
+	iretq
+
+; Local APIC one-shot timer (tickless mode): the same work as a PIT tick
+_apicTimerHandler:
+	pushState
+	call kernelLock
+
+	mov rdi, 0 ; pass argument to irqDispatcher
+	call irqDispatcher
+
+	call kernelUnlock
+
+	mov rdi, rsp ; frame of the interrupted process
+	call schedulerTick
+	mov rsp, rax ; frame of the process to resume
+	call finishSwitch
+
+	call apicInterruptEnd ; arms the next deadline and signals the local APIC EOI
+
+	popState
+	iretq
+
+; Reschedule IPI, and the local APIC timer of the application processors (end of their quantum)
+_rescheduleHandler:
+	pushState
+
+	mov rdi, rsp ; frame of the interrupted process
+	call schedulerTick
+	mov rsp, rax ; frame of the process to resume
+	call finishSwitch
+
+	call apicInterruptEnd
+
+	popState
+	iretq
+
+; Local APIC spurious interrupt: no EOI
+_spuriousHandler:
+	iretq
 
 ; Keyboard
 _irq01Handler:
 	pushfq
 	pushState
+	call kernelLock
 
 	mov rdi, 1 ; pass argument to irqDispatcher
 	call irqDispatcher
@@ -204,33 +316,58 @@ _irq01Handler:
 	mov byte [register_snapshot_taken], 0x01
 
 	.skip:
-	; signal pic EOI (End of Interrupt)
-	mov al, 20h
-	out 20h, al
+	signalEOI
 
+	call kernelUnlock
 	popState
 	add rsp, 0x08 ; remove rflags from the stack
 
 	iretq
 
-; System Call
+; System Call (compatibility path)
 ; Not using the %irqHandlerMaster macro because it needs to pass the stack pointer to the syscall
+; int 0x80 is not a hardware IRQ, so there is no EOI to send
 _irq80Handler:
 	pushState
 
 	mov rdi, rsp ; pass REGISTERS (stack) to irqDispatcher, see: `pushState` two lines above
 	call syscallDispatcher
 
-	mov rbx, rax
+	popStateButRAX
+	add rsp, 8 ; skip the rax pushed by pushState, it holds the return value now
+	iretq
+
+; System Call (fast path), entered through the SYSCALL instruction, see `load_syscalls`
+; The CPU leaves the return rip in rcx and the caller's rflags in r11, and masks IF like an interrupt gate.
+; libsys stubs are plain C calls, so only rcx/r11 have to survive: syscallDispatch preserves the
+; callee-saved registers itself, and everything else is caller-saved anyway.
+; Userland runs in ring 0 as well, and SYSRET always returns to ring 3, so we return with popfq + ret.
+_syscallHandler:
+	push rcx ; return address
+	push r11 ; caller's rflags
+
+	; SYSCALL loaded SS with STAR's selector + 8, which is Pure64's read-only data descriptor;
+	; put back the null SS the kernel runs with, or the next iretq to this stack would fault
+	xor r11d, r11d
+	mov ss, r11w
+
+	mov rcx, r10 ; 4th argument, moved out of rcx by the libsys stub
+	mov r9, rax  ; syscall number goes last
+	call syscallDispatch
+
+	popfq
+	ret
 
-	; signal pic EOI (End of Interrupt)
-	mov al, 20h
-	out 20h, al
+; Yield (int 0x81): saves the running process and switches to the one picked by the scheduler
+_irq81Handler:
+	pushState
 
-	mov rax, rbx
+	mov rdi, rsp
+	call schedule ; the kernel lock goes with the process that had it, see kernelLock.h
+	mov rsp, rax
+	call finishSwitch
 
-	popStateButRAX
-	add rsp, 8 ; skip the error code pushed by irqDispatcher
+	popState
 	iretq
 
 ; Zero Division Exception
@@ -11,6 +11,17 @@ GLOBAL setSpeaker
 
 GLOBAL getRegisterSnapshot
 
+GLOBAL _rdtsc
+GLOBAL _readMSR
+GLOBAL _writeMSR
+GLOBAL _inb
+GLOBAL _outb
+GLOBAL getCpu
+GLOBAL _cpuidExtendedFeatures
+GLOBAL _repStosq
+GLOBAL _repMovsb
+GLOBAL _repMovsq
+
 EXTERN register_snapshot
 EXTERN register_snapshot_taken
 
@@ -119,3 +130,125 @@ setSpeaker:
 	mov rsp, rbp
 	pop rbp
 	ret
+
+
+; Returns the 64-bit time stamp counter (cycles since reset)
+_rdtsc:
+	push rbp
+	mov rbp, rsp
+
+	rdtsc
+	shl rdx, 32
+	or rax, rdx
+
+	mov rsp, rbp
+	pop rbp
+	ret
+
+
+; uint64_t _readMSR(uint32_t msr)
+_readMSR:
+	push rbp
+	mov rbp, rsp
+
+	mov ecx, edi
+	rdmsr
+	shl rdx, 32
+	or rax, rdx
+
+	mov rsp, rbp
+	pop rbp
+	ret
+
+
+; void _writeMSR(uint32_t msr, uint64_t value)
+_writeMSR:
+	push rbp
+	mov rbp, rsp
+
+	mov ecx, edi
+	mov eax, esi
+	mov rdx, rsi
+	shr rdx, 32
+	wrmsr
+
+	mov rsp, rbp
+	pop rbp
+	ret
+
+
+; uint8_t _inb(uint16_t port)
+_inb:
+	push rbp
+	mov rbp, rsp
+
+	mov dx, di
+	xor rax, rax
+	in al, dx
+
+	mov rsp, rbp
+	pop rbp
+	ret
+
+
+; void _outb(uint16_t port, uint8_t value)
+_outb:
+	push rbp
+	mov rbp, rsp
+
+	mov dx, di
+	mov al, sil
+	out dx, al
+
+	mov rsp, rbp
+	pop rbp
+	ret
+
+
+; Cpu * getCpu(void): every CPU's GS base points at its Cpu, whose first field points back at it
+getCpu:
+	mov rax, [gs:0]
+	ret
+
+
+; uint32_t _cpuidExtendedFeatures(void): EBX of CPUID leaf 7 (bit 9 is ERMS, fast rep movsb/stosb), 0 if there is no leaf 7
+_cpuidExtendedFeatures:
+	push rbx
+
+	xor eax, eax
+	cpuid
+	cmp eax, 7
+	jb .none
+
+	mov eax, 7
+	xor ecx, ecx
+	cpuid
+	mov eax, ebx
+	jmp .end
+.none:
+	xor eax, eax
+.end:
+	pop rbx
+	ret
+
+
+; void _repStosq(void * destination, uint64_t pattern, uint64_t count): stores `pattern` `count` times
+_repStosq:
+	mov rax, rsi
+	mov rcx, rdx
+	rep stosq
+	ret
+
+
+; void _repMovsb(void * destination, const void * source, uint64_t length)
+_repMovsb:
+	mov rcx, rdx
+	rep movsb
+	ret
+
+
+; void _repMovsq(void * destination, const void * source, uint64_t count): copies `count` qwords
+_repMovsq:
+	mov rcx, rdx
+	rep movsq
+	ret
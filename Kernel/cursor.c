@@ -3,7 +3,7 @@
 #include <fonts.h>
 #include <keyboard.h>
 
-#define TOGGLE_TICKS 9
+#define TOGGLE_TICKS (TIMER_FREQUENCY / 2)
 
 static uint8_t IS_SHOWING = 0;
 
@@ -15,9 +15,17 @@ int toggleSpeed(void) {
     return ticks_elapsed() / TOGGLE_TICKS;
 }
 
+static int isBlinking(void) {
+    return !(keyboard_options == 0 || keyboard_options == MODIFY_BUFFER);
+}
+
+uint64_t nextCursorToggle(uint64_t tick) {
+    return isBlinking() ? (tick / TOGGLE_TICKS + 1) * TOGGLE_TICKS : UINT64_MAX;
+}
+
 void toggleCursor(void) {
     int toggle = toggleSpeed() % 2;
-    if (keyboard_options == 0 || keyboard_options == MODIFY_BUFFER){
+    if (!isBlinking()){
         IS_SHOWING = 0;
     } else{
         if ((toggle == 1) && !IS_SHOWING) {
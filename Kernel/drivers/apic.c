@@ -0,0 +1,176 @@
+#include <apic.h>
+#include <stddef.h>
+
+// https://wiki.osdev.org/APIC
+#define PURE64_LAPIC_ADDRESS    ((uint64_t *) 0x5060)   // Pure64 info map entries
+#define PURE64_IOAPIC_COUNT     ((uint8_t *) 0x5030)
+#define PURE64_IOAPIC_ADDRESS   ((uint32_t *) 0x5068)   // first IO-APIC: address, then its first GSI
+
+#define LAPIC_ID                0x020
+
+#define LAPIC_EOI               0x0B0
+#define LAPIC_SPURIOUS          0x0F0
+#define LAPIC_ICR_LOW           0x300   // writing it sends the IPI
+#define LAPIC_ICR_HIGH          0x310
+#define LAPIC_LVT_TIMER         0x320
+#define LAPIC_TIMER_INITIAL     0x380
+#define LAPIC_TIMER_CURRENT     0x390
+#define LAPIC_TIMER_DIVIDE      0x3E0
+
+#define LAPIC_ENABLE            0x100   // spurious vector register, software enable
+#define LVT_MASKED              0x10000 // LVT entries: bit 16, bits 17-18 = 00 is one-shot mode
+#define TIMER_DIVIDE_BY_16      0x3
+#define ICR_PENDING             0x1000  // delivery status
+#define ICR_ASSERT              0x4000  // fixed delivery, physical destination, edge otherwise
+#define ICR_DESTINATION_SHIFT   24      // in the high dword
+
+// https://wiki.osdev.org/IOAPIC
+#define IOAPIC_REGSEL           0x00
+#define IOAPIC_WINDOW           0x10
+#define IOAPIC_VERSION          0x01
+#define IOAPIC_REDIRECTION(pin) (0x10 + 2 * (pin))     // low dword, the high one follows
+
+#define MAX_IOAPIC_PINS         24
+#define REDIRECTION_MASKED      0x10000 // fixed delivery, physical destination, edge, active high otherwise
+#define DESTINATION_SHIFT       24      // in the high dword
+
+/*
+ * ISA IRQ 0 (the PIT) comes in on pin 2 on every ACPI machine we boot on; Pure64
+ * parses the MADT interrupt source overrides but does not keep them, so this is
+ * the only one we account for. The rest are identity mapped.
+ */
+#define ISA_TIMER_IRQ           0
+#define ISA_TIMER_PIN           2
+
+static volatile uint32_t * lapic = NULL;
+static volatile uint32_t * ioapic = NULL;
+static uint32_t ioapicPins = 0;
+static uint8_t routedVectors[MAX_IOAPIC_PINS] = { 0 };     // 0: pin masked
+static uint8_t onlineApics[256 / 8] = { 0 };               // CPUs that ran initLocalApic
+
+// Read by interrupts.asm: the LAPIC EOI register while the IO-APIC routes IRQs, NULL under the 8259
+volatile uint32_t * irq_eoi_register = NULL;
+
+static inline uint32_t lapicRead(uint32_t reg) {
+    return lapic[reg / sizeof(uint32_t)];
+}
+
+static inline void lapicWrite(uint32_t reg, uint32_t value) {
+    lapic[reg / sizeof(uint32_t)] = value;
+}
+
+uint8_t initLocalApic(void) {
+    uint64_t address = *PURE64_LAPIC_ADDRESS;
+    if (address == 0)
+        return 0;
+
+    lapic = (volatile uint32_t *) address;
+    lapicWrite(LAPIC_SPURIOUS, lapicRead(LAPIC_SPURIOUS) | LAPIC_ENABLE);
+    lapicWrite(LAPIC_TIMER_DIVIDE, TIMER_DIVIDE_BY_16);
+    lapicWrite(LAPIC_LVT_TIMER, LVT_MASKED | APIC_TIMER_VECTOR);
+    lapicWrite(LAPIC_TIMER_INITIAL, 0);
+
+    uint8_t id = lapicId();
+    onlineApics[id / 8] |= 1 << (id % 8);
+    return 1;
+}
+
+uint8_t lapicId(void) {
+    return lapicRead(LAPIC_ID) >> 24;
+}
+
+void lapicEOI(void) {
+    lapicWrite(LAPIC_EOI, 0);
+}
+
+void lapicTimerStart(uint32_t count) {
+    lapicWrite(LAPIC_TIMER_INITIAL, count);
+}
+
+uint32_t lapicTimerRemaining(void) {
+    return lapicRead(LAPIC_TIMER_CURRENT);
+}
+
+void lapicTimerUnmask(uint8_t vector) {
+    lapicWrite(LAPIC_LVT_TIMER, vector);
+}
+
+void lapicTimerMask(void) {
+    lapicWrite(LAPIC_LVT_TIMER, LVT_MASKED | (lapicRead(LAPIC_LVT_TIMER) & 0xFF));
+}
+
+void lapicSendIpi(uint8_t apicId, uint8_t vector) {
+    while (lapicRead(LAPIC_ICR_LOW) & ICR_PENDING)
+        __builtin_ia32_pause();
+    lapicWrite(LAPIC_ICR_HIGH, (uint32_t) apicId << ICR_DESTINATION_SHIFT);
+    lapicWrite(LAPIC_ICR_LOW, ICR_ASSERT | vector);
+}
+
+static uint32_t ioapicRead(uint32_t reg) {
+    ioapic[IOAPIC_REGSEL / sizeof(uint32_t)] = reg;
+    return ioapic[IOAPIC_WINDOW / sizeof(uint32_t)];
+}
+
+static void ioapicWrite(uint32_t reg, uint32_t value) {
+    ioapic[IOAPIC_REGSEL / sizeof(uint32_t)] = reg;
+    ioapic[IOAPIC_WINDOW / sizeof(uint32_t)] = value;
+}
+
+static int32_t irqToPin(uint8_t irq) {
+    uint32_t pin = irq == ISA_TIMER_IRQ ? ISA_TIMER_PIN : irq;
+    return pin < ioapicPins ? (int32_t) pin : -1;
+}
+
+static void writeRedirection(uint32_t pin, uint32_t low, uint8_t apicId) {
+    // Masked while the destination changes, so the pin never fires half written
+    ioapicWrite(IOAPIC_REDIRECTION(pin), REDIRECTION_MASKED);
+    ioapicWrite(IOAPIC_REDIRECTION(pin) + 1, (uint32_t) apicId << DESTINATION_SHIFT);
+    ioapicWrite(IOAPIC_REDIRECTION(pin), low);
+}
+
+uint8_t initIoApic(void) {
+    // ISA IRQs live on the IO-APIC that starts at GSI 0; Pure64 lists it first
+    if (lapic == NULL || *PURE64_IOAPIC_COUNT == 0 || PURE64_IOAPIC_ADDRESS[0] == 0 || PURE64_IOAPIC_ADDRESS[1] != 0)
+        return 0;
+
+    ioapic = (volatile uint32_t *) (uint64_t) PURE64_IOAPIC_ADDRESS[0];
+    ioapicPins = ((ioapicRead(IOAPIC_VERSION) >> 16) & 0xFF) + 1;
+    if (ioapicPins > MAX_IOAPIC_PINS)
+        ioapicPins = MAX_IOAPIC_PINS;
+
+    for (uint32_t pin = 0; pin < ioapicPins; pin++)
+        writeRedirection(pin, REDIRECTION_MASKED, 0);
+
+    irq_eoi_register = &lapic[LAPIC_EOI / sizeof(uint32_t)];
+    return 1;
+}
+
+uint8_t ioapicRoute(uint8_t irq, uint8_t vector) {
+    int32_t pin = irqToPin(irq);
+    if (ioapic == NULL || pin < 0 || vector == 0)
+        return 0;
+
+    routedVectors[pin] = vector;
+    writeRedirection(pin, vector, lapicId());
+    return 1;
+}
+
+int8_t ioapicSetAffinity(uint8_t irq, uint8_t apicId) {
+    int32_t pin = irqToPin(irq);
+    if (ioapic == NULL || pin < 0 || routedVectors[pin] == 0)
+        return -1;
+
+    // An APIC that never ran initLocalApic would take the IRQ and never EOI it
+    if (!(onlineApics[apicId / 8] & (1 << (apicId % 8))))
+        return -1;
+
+    writeRedirection(pin, routedVectors[pin], apicId);
+    return 0;
+}
+
+int16_t ioapicAffinity(uint8_t irq) {
+    int32_t pin = irqToPin(irq);
+    if (ioapic == NULL || pin < 0 || routedVectors[pin] == 0)
+        return -1;
+    return ioapicRead(IOAPIC_REDIRECTION(pin) + 1) >> DESTINATION_SHIFT;
+}
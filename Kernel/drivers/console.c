@@ -0,0 +1,131 @@
+/*
+ * Character devices backed by the screen and the keyboard, plus the null device.
+ * A console write goes to the screen in as few printColored calls as its
+ * escape sequences allow, instead of one putChar per character, and flushes
+ * the back buffer once at the end.
+ */
+
+#include <console.h>
+#include <fileDescriptor.h>
+#include <keyboard.h>
+#include <fonts.h>
+#include <video.h>
+#include <lib.h>
+#include <stddef.h>
+
+enum ESCAPE_STATE {
+    ESCAPE_NONE = 0,
+    ESCAPE_STARTED,     // got '\e'
+    ESCAPE_PARAMETERS,  // got "\e[", reading "n;n;...m"
+};
+
+static ConsoleStream outputStream = { DEFAULT_TEXT_COLOR, DEFAULT_BACKGROUND_COLOR, DEFAULT_TEXT_COLOR, ESCAPE_NONE, 0 };
+static ConsoleStream errorStream = { DEFAULT_ERROR_COLOR, DEFAULT_BACKGROUND_COLOR, DEFAULT_ERROR_COLOR, ESCAPE_NONE, 0 };
+
+ConsoleStream *getConsoleStream(int32_t stream) {
+    switch (stream) {
+        case FD_STDOUT: return &outputStream;
+        case FD_STDERR: return &errorStream;
+        default:        return NULL;
+    }
+}
+
+// 4 bit ANSI SGR codes: 30-37 / 90-97 text, 40-47 / 100-107 background, 0 resets
+static void setANSIProp(ConsoleStream *stream, uint8_t prop) {
+    uint32_t *color = &stream->textColor;
+
+    if ((prop >= 40 && prop <= 47) || (prop >= 100 && prop <= 107)) {
+        prop -= 10;
+        color = &stream->backgroundColor;
+    }
+
+    switch (prop) {
+        case 0:
+            stream->textColor = stream->defaultTextColor;
+            stream->backgroundColor = DEFAULT_BACKGROUND_COLOR;
+            break;
+        case 30: *color = 0x00000000; break;
+        case 31: *color = 0x00DE382B; break;
+        case 32: *color = 0x0039B54A; break;
+        case 33: *color = 0x00FFC706; break;
+        case 34: *color = 0x00006FB8; break;
+        case 35: *color = 0x00762671; break;
+        case 36: *color = 0x002CB5E9; break;
+        case 37: *color = 0x00CCCCCC; break;
+        case 90: *color = 0x00808080; break;
+        case 91: *color = 0x00FF0000; break;
+        case 92: *color = 0x0000FF00; break;
+        case 93: *color = 0x00FFFF00; break;
+        case 94: *color = 0x000000FF; break;
+        case 95: *color = 0x00FF00FF; break;
+        case 96: *color = 0x0000FFFF; break;
+        case 97: *color = 0x00FFFFFF; break;
+        default: break;
+    }
+}
+
+static void parseEscape(ConsoleStream *stream, uint8_t c) {
+    switch (stream->escapeState) {
+        case ESCAPE_NONE:
+            stream->escapeState = ESCAPE_STARTED;
+            break;
+        case ESCAPE_STARTED:
+            stream->escapeState = c == '[' ? ESCAPE_PARAMETERS : ESCAPE_NONE;
+            stream->escapeProp = 0;
+            break;
+        case ESCAPE_PARAMETERS:
+            if (c >= '0' && c <= '9') {
+                stream->escapeProp = stream->escapeProp * 10 + (c - '0');
+            } else if (c == ';' || c == 'm') {
+                setANSIProp(stream, stream->escapeProp);
+                stream->escapeProp = 0;
+                if (c == 'm') stream->escapeState = ESCAPE_NONE;
+            } else {
+                stream->escapeState = ESCAPE_NONE;  // not a color sequence, dropped
+            }
+            break;
+    }
+}
+
+static int64_t consoleWrite(void *context, const uint8_t *buffer, uint64_t count) {
+    ConsoleStream *stream = context;
+    uint64_t run = 0;   // start of the plain characters not printed yet
+
+    for (uint64_t i = 0; i < count; i++) {
+        if (stream->escapeState == ESCAPE_NONE && buffer[i] != ESCAPE_CHAR)
+            continue;
+        printColored((const char *) buffer + run, i - run, stream->textColor, stream->backgroundColor);
+        parseEscape(stream, buffer[i]);
+        run = i + 1;
+    }
+
+    printColored((const char *) buffer + run, count - run, stream->textColor, stream->backgroundColor);
+    flushVideo();   // output shows up when the write returns, not on the next timer flush
+    return count;
+}
+
+static int64_t keyboardRead(void *context, uint8_t *buffer, uint64_t count) {
+    uint64_t i;
+    int8_t c;
+    for (i = 0; i < count && (c = getKeyboardCharacter(AWAIT_RETURN_KEY | SHOW_BUFFER_WHILE_TYPING)) != EOF; i++)
+        buffer[i] = c;
+    return i;
+}
+
+static int64_t keyboardWrite(void *context, const uint8_t *buffer, uint64_t count) {
+    for (uint64_t i = 0; i < count; i++)
+        addCharToBuffer(buffer[i], 1);
+    return count;
+}
+
+static int64_t nullRead(void *context, uint8_t *buffer, uint64_t count) {
+    return 0;
+}
+
+static int64_t nullWrite(void *context, const uint8_t *buffer, uint64_t count) {
+    return count;
+}
+
+const Device consoleDevice = { "console", NULL, consoleWrite, NULL, NULL };
+const Device keyboardDevice = { "keyboard", keyboardRead, keyboardWrite, NULL, NULL };
+const Device nullDevice = { "null", nullRead, nullWrite, NULL, NULL };
@@ -2,6 +2,10 @@
 #include <fonts.h>
 #include <interrupts.h>
 #include <cursor.h>
+#include <time.h>
+#include <scheduler.h>
+#include <waitQueue.h>
+#include <spinlock.h>
 #include <stddef.h>
 
 #define BUFFER_SIZE 1024
@@ -34,7 +38,9 @@
 static uint8_t SHIFT_KEY_PRESSED, CAPS_LOCK_KEY_PRESSED, CONTROL_KEY_PRESSED;
 static int8_t buffer[BUFFER_SIZE];
 static uint16_t to_write = 0, to_read = 0;
+static Spinlock bufferLock = NAMED_SPINLOCK_INIT("keyboard");  // guards buffer, to_write and to_read
 uint8_t keyboard_options = 0;
+static WaitQueue readers = WAIT_QUEUE_INIT;  // blocked in getKeyboardCharacter until the next key
 
 typedef struct {
     uint8_t registered_from_kernel;
@@ -191,7 +197,8 @@ static uint8_t makeCode(uint8_t scancode) {
     return scancode & 0x7F;
 }
 
-void addCharToBuffer(int8_t ascii, uint8_t showOutput) {
+// Caller holds bufferLock
+static void bufferChar(int8_t ascii, uint8_t showOutput) {
     if (ascii != TABULATOR_CHAR) {
         buffer[to_write] = ascii;
         INC_MOD(to_write, BUFFER_SIZE);
@@ -201,32 +208,62 @@ void addCharToBuffer(int8_t ascii, uint8_t showOutput) {
     }
 
     do {
-        addCharToBuffer(' ', showOutput);
+        bufferChar(' ', showOutput);
     } while( !BUFFER_IS_FULL && getXBufferPosition() % (TAB_SIZE * DEFAULT_GLYPH_SIZE_X * getFontSize()) != 0);
 }
 
+void addCharToBuffer(int8_t ascii, uint8_t showOutput) {
+    uint64_t flags = spinLockIrqSave(&bufferLock);
+    bufferChar(ascii, showOutput);
+    spinUnlockIrqRestore(&bufferLock, flags);
+}
+
 uint16_t clearBuffer() {
+    uint64_t flags = spinLockIrqSave(&bufferLock);
     uint16_t aux = SUB_MOD(to_write, to_read, BUFFER_SIZE);
-    if (aux == 0) return 0;
-    DEC_MOD(to_write, BUFFER_SIZE);
-    clearPreviousCharacter();
+    if (aux != 0) {
+        DEC_MOD(to_write, BUFFER_SIZE);
+        clearPreviousCharacter();
+    }
+    spinUnlockIrqRestore(&bufferLock, flags);
     return aux;
 }
 
-// Halts until any key is pressed or \n is entered, depending on keyboard_options (AWAIT_RETURN_KEY)
+// Blocks the caller until the keyboard interrupt handles another key. The kernel lock is handed over
+// with the CPU, so other CPUs get into the kernel meanwhile; before there are processes it just halts
+static void awaitKey(void) {
+    Process *self = getCurrentProcess();
+    if (self == NULL) {
+        _hlt();
+        _cli();
+        return;
+    }
+    waitQueueAdd(&readers, self);
+    yield();
+}
+
+// Blocks until any key is pressed or \n is entered, depending on keyboard_options (AWAIT_RETURN_KEY)
 // This function always sets the MODIFY_BUFFER option, so keys can be consumed
 int8_t getKeyboardCharacter(enum KEYBOARD_OPTIONS ops) {
     keyboard_options = ops | MODIFY_BUFFER;
+    bootTimerDeadlinesChanged(); // the cursor may start blinking, on the boot CPU's timer
 
+    // Dropped while waiting; the kernel lock keeps the handler from slipping a key in before awaitKey
+    uint64_t flags = spinLockIrqSave(&bufferLock);
     while(
         to_write == to_read || // always get at least one char from the buffer if empty
         (   (keyboard_options & AWAIT_RETURN_KEY) && // wait for \n or EOF to be entered by the user
             !(buffer[SUB_MOD(to_write, 1, BUFFER_SIZE)] == NEW_LINE_CHAR || buffer[SUB_MOD(to_write, 1, BUFFER_SIZE)] == EOF)
-        )) _hlt();
+        )) {
+        spinUnlockIrqRestore(&bufferLock, flags);
+        awaitKey();
+        flags = spinLockIrqSave(&bufferLock);
+    }
 
     keyboard_options = 0;
     int8_t aux = buffer[to_read];
     INC_MOD(to_read, BUFFER_SIZE);
+    spinUnlockIrqRestore(&bufferLock, flags);
     return aux;
 }
 
@@ -234,10 +271,14 @@ uint8_t keyboardHandler(){
     uint8_t scancode = getKeyboardBuffer();
     uint8_t is_pressed = isPressed(scancode);
 
+    // Interrupts are already off in here
+    spinLock(&bufferLock);
     if(BUFFER_IS_FULL){
         to_read = to_write = 0;
+        spinUnlock(&bufferLock);
         return scancode; // do not write to buffer anymore, subsequent keys are not processed into the buffer
     }
+    spinUnlock(&bufferLock);
     
     switch (makeCode(scancode)) {
         case SHIFT_KEY_L:
@@ -258,6 +299,7 @@ uint8_t keyboardHandler(){
     if (! (is_pressed && IS_KEYCODE(scancode)) ) return scancode; // ignore break or unsupported scancodes
     
     if ((keyboard_options & MODIFY_BUFFER) != 0) {
+        spinLock(&bufferLock);
         int8_t c = scancodeMap[scancode][SHIFT_KEY_PRESSED];
 
         if (CAPS_LOCK_KEY_PRESSED == 1) {
@@ -269,17 +311,20 @@ uint8_t keyboardHandler(){
                 c = NEW_LINE_CHAR;
                 // Handle \n on the keyboard interrupt handler, to avoid the possibility of triggering multiple \n inputs continously on the same sys_read
                 if ( (to_write != to_read) && buffer[SUB_MOD(to_write, 1, BUFFER_SIZE)] == NEW_LINE_CHAR ) {
+                    spinUnlock(&bufferLock);
                     return scancode;
                 }
             } else if(c == TABULATOR_KEY){
                 c = TABULATOR_CHAR;
             }
 
-            addCharToBuffer(c, keyboard_options & SHOW_BUFFER_WHILE_TYPING);
+            bufferChar(c, keyboard_options & SHOW_BUFFER_WHILE_TYPING);
         } else if (c == BACKSPACE_KEY && to_write != to_read) {
             DEC_MOD(to_write, BUFFER_SIZE);
             clearPreviousCharacter();
         }
+        spinUnlock(&bufferLock);
+        waitQueueWakeAll(&readers);
     }
 
     // Call the registered function for the key, if any
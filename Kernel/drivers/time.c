@@ -3,27 +3,211 @@
 
 #include <fonts.h>
 #include<cursor.h>
+#include <video.h>
+#include <scheduler.h>
+#include <sleepQueue.h>
+#include <apic.h>
+#include <cpu.h>
+#include <kernelLock.h>
+#include <stddef.h>
+#include <lib.h>
 
+#define PIT_FREQUENCY   1193182     // input clock of every PIT channel, in Hz
+#define PIT_CHANNEL0    0x40
+#define PIT_CHANNEL2    0x42
+#define PIT_COMMAND     0x43
+#define PIT_GATE_PORT   0x61        // bit 0: channel 2 gate, bit 1: speaker, bit 5: channel 2 output
+
+#define CALIBRATION_MS          10
+#define CALIBRATION_MAX_POLLS   10000000    // gives up (no TSC clock) if channel 2 never fires
+
+// Tickless mode still wakes up once a second, so the tick count never lags far behind the TSC
+#define MAX_ONE_SHOT_TICKS      TIMER_FREQUENCY
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+/*
+ * Ticks are TIMER_FREQUENCY per second either way. With the PIT every one is
+ * an interrupt; in tickless mode the local APIC timer is programmed one-shot
+ * for the earliest deadline (sleeper, scheduler quantum, cursor blink) and
+ * each interrupt catches `ticks` up with the TSC, accounting for all the
+ * ticks that went by without one.
+ *
+ * The other CPUs only keep time for their scheduler: whichever way the boot
+ * CPU ticks, each of them programs its own local APIC timer one-shot for the
+ * end of its quantum, and leaves it stopped while nobody is waiting for it.
+ */
 static unsigned long ticks = 0;
+static uint8_t tickless = 0;
+
+static uint64_t tscFrequency = 0;
+static uint64_t tscAtBoot = 0;
+static uint64_t tscToNanoseconds = 0;   // 32.32 fixed point nanoseconds per cycle
+static uint64_t apicCountsPerTick = 0;
+
+// Times CALIBRATION_MS of PIT channel 2 (one-shot, polled through port 0x61) in TSC cycles and local APIC timer counts
+static void calibrateClocks(uint8_t hasApic) {
+	uint16_t count = PIT_FREQUENCY * CALIBRATION_MS / 1000;
+	uint8_t gate = _inb(PIT_GATE_PORT);
+
+	_outb(PIT_GATE_PORT, (gate & ~0x02) | 0x01);	// gate on, speaker off
+	_outb(PIT_COMMAND, 0xB0);						// channel 2, lobyte/hibyte, mode 0 (interrupt on terminal count)
+	_outb(PIT_CHANNEL2, count & 0xFF);
+	_outb(PIT_CHANNEL2, count >> 8);
+
+	if (hasApic)
+		lapicTimerStart(UINT32_MAX);
+	uint64_t start = _rdtsc();
+	uint32_t polls = 0;
+	while (!(_inb(PIT_GATE_PORT) & 0x20) && polls < CALIBRATION_MAX_POLLS)
+		polls++;
+	uint64_t end = _rdtsc();
+	uint32_t apicCounts = hasApic ? UINT32_MAX - lapicTimerRemaining() : 0;
+	if (hasApic)
+		lapicTimerStart(0);
+
+	_outb(PIT_GATE_PORT, gate);
+	tscAtBoot = end;
+
+	if (polls == CALIBRATION_MAX_POLLS || end <= start)
+		return;
+
+	tscFrequency = (end - start) * 1000 / CALIBRATION_MS;
+	tscToNanoseconds = (NANOSECONDS_PER_SECOND << 32) / tscFrequency;
+	apicCountsPerTick = (uint64_t)apicCounts * 1000 / CALIBRATION_MS / TIMER_FREQUENCY;
+}
+
+// Current tick according to the TSC, which keeps counting between tickless interrupts
+static uint64_t currentTick(void) {
+	return tickless ? monotonicNanoseconds() / (NANOSECONDS_PER_SECOND / TIMER_FREQUENCY) : ticks;
+}
+
+// Programs this CPU's one-shot for the earliest deadline it is responsible for.
+// The scheduler's is per CPU; the boot CPU's others belong to the kernel lock, which the switch path does not hold.
+static void armNextTimer(void) {
+	uint64_t now = currentTick();
+	uint64_t deadline = schedulerNextDeadline();
+	if (getCpu()->index == BOOT_CPU) {
+		kernelLock();
+		deadline = MIN(deadline, now + MAX_ONE_SHOT_TICKS);
+		deadline = MIN(deadline, sleepQueueNextWake());
+		deadline = MIN(deadline, nextCursorToggle(now));
+		deadline = MIN(deadline, nextVideoFlush(now));
+		kernelUnlock();
+	} else if (deadline == UINT64_MAX) {
+		lapicTimerStart(0);
+		return;
+	}
+
+	uint64_t wait = deadline > now ? deadline - now : 1;
+	lapicTimerStart(MIN(wait * apicCountsPerTick, UINT32_MAX));
+}
+
+void initTimer(void) {
+	_cli();
+
+	uint16_t divisor = PIT_FREQUENCY / TIMER_FREQUENCY;
+	_outb(PIT_COMMAND, 0x34);	// channel 0, lobyte/hibyte, mode 2 (rate generator)
+	_outb(PIT_CHANNEL0, divisor & 0xFF);
+	_outb(PIT_CHANNEL0, divisor >> 8);
+
+	uint8_t hasApic = initLocalApic();
+	calibrateClocks(hasApic);
+
+	// Tickless needs the TSC to tell time between interrupts and a usable APIC timer to fire them
+	tickless = hasApic && tscToNanoseconds != 0 && apicCountsPerTick != 0;
+	if (tickless) {
+		ticks = currentTick();
+		lapicTimerUnmask(APIC_TIMER_VECTOR);
+		armNextTimer();
+	}
+}
+
+uint8_t hasLocalTimer(void) {
+	return apicCountsPerTick != 0;
+}
+
+void initCpuTimer(void) {
+	lapicTimerUnmask(APIC_RESCHEDULE_VECTOR);
+	lapicTimerStart(0);
+}
+
+uint8_t isTickless(void) {
+	return tickless;
+}
+
+void timerDeadlinesChanged(void) {
+	if (tickless || getCpu()->index != BOOT_CPU)
+		armNextTimer();
+}
+
+void bootTimerDeadlinesChanged(void) {
+	if (getCpu()->index == BOOT_CPU)
+		timerDeadlinesChanged();
+	else if (tickless)
+		sendReschedule(getCpuByIndex(BOOT_CPU));	// it re-arms on the way out of the IPI
+}
+
+void apicInterruptEnd(void) {
+	timerDeadlinesChanged();
+	lapicEOI();
+}
+
+uint64_t monotonicNanoseconds(void) {
+	if (tscToNanoseconds == 0)
+		return (uint64_t)ticks * (NANOSECONDS_PER_SECOND / TIMER_FREQUENCY);
+
+	// 128 bit product: the cycle count times a 32.32 factor overflows 64 bits within seconds
+	return ((unsigned __int128)(_rdtsc() - tscAtBoot) * tscToNanoseconds) >> 32;
+}
+
+uint64_t getTSCFrequency(void) {
+	return tscFrequency;
+}
 
 void timer_handler() {
-	ticks++;
+	if (tickless) {
+		uint64_t tick = currentTick();
+		if (tick > ticks)
+			ticks = tick;
+	} else {
+		ticks++;
+	}
+	sleepQueueWake(ticks);
 
 	toggleCursor();
+	flushVideoIfDue(ticks);
+}
+
+uint64_t getTicks(void) {
+	return tickless ? currentTick() : ticks;
 }
 
 int ticks_elapsed() {
-	return ticks;
+	return currentTick();
 }
 
 int seconds_elapsed() {
-	return ticks / SECONDS_TO_TICKS;
+	return currentTick() / SECONDS_TO_TICKS;
 }
 
+// Blocks the running process in the sleep queue; the timer readies it once the ticks are up.
+// Callers run with interrupts disabled, as syscalls do, so the wakeup cannot come before the yield.
+// Before the scheduler starts there is nobody else to run, so it just halts until then.
 void sleepTicks(uint64_t sleep_t) {
-	unsigned long start = ticks;
-	while (ticks < start + sleep_t) _hlt();
-	return;
+	Process * process = getCurrentProcess();
+	if (process == NULL) {
+		unsigned long start = currentTick();
+		while (currentTick() < start + sleep_t) _hlt();
+		return;
+	}
+
+	if (sleep_t == 0)
+		return;
+
+	sleepQueueAdd(process, currentTick() + sleep_t);
+	bootTimerDeadlinesChanged();	// the sleep queue is watched by the boot CPU
+	yield();
 }
 
 void sleep(int seconds) {
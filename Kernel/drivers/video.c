@@ -7,6 +7,10 @@
 
 #include <video.h>
 #include <interrupts.h>
+#include <spinlock.h>
+#include <lib.h>
+#include <time.h>
+#include <memoryManager.h>
 
 struct vbe_mode_info_structure {
 	uint16_t attributes;		// deprecated, only bit 7 should be of interest to you, and it indicates the mode supports a linear frame buffer.
@@ -50,55 +54,231 @@ typedef struct vbe_mode_info_structure * VBEInfoPtr;
 
 VBEInfoPtr VBE_mode_info = (VBEInfoPtr) 0x0000000000005C00;
 
-void putPixel(uint32_t hexColor, uint64_t x, uint64_t y) {
-    uint8_t * framebuffer = (uint8_t * )(unsigned long long)(VBE_mode_info->framebuffer);
-    uint64_t offset = (x * ((VBE_mode_info->bpp) >> 3)) + (y * VBE_mode_info->pitch);
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+/*
+ * Span kernels, picked once by initVideo: fillSpan writes `count` pixels of
+ * one color and copySpan moves `length` bytes. The kernel is built without
+ * SSE, so the widest store is 8 bytes: a 32 bpp fill is `rep stosq` of two
+ * pixels, a 24 bpp one stores 3 qwords per 8 pixels. Copies use `rep movsb`
+ * when the CPU has ERMS (it then moves whole lines internally), `rep movsq`
+ * otherwise. The defaults are the generic ones, for whatever draws before
+ * initVideo.
+ */
+typedef void (*FillSpan)(uint8_t * destination, uint32_t hexColor, uint64_t count);
+typedef void (*CopySpan)(uint8_t * destination, const uint8_t * source, uint64_t length);
+
+static void fillSpanBytes(uint8_t * destination, uint32_t hexColor, uint64_t count) {
+	uint8_t bytesPerPixel = VBE_mode_info->bpp >> 3;
 	uint8_t b = (hexColor) & 0xFF, g = (hexColor >> 8) & 0xFF, r = (hexColor >> 16) & 0xFF;
+	for (uint64_t i = 0; i < count; i++, destination += bytesPerPixel) {
+		destination[0] = b;
+		destination[1] = g;
+		destination[2] = r;
+	}
+}
 
-    framebuffer[offset]     =  b;
-    framebuffer[offset+1]   =  g;
-    framebuffer[offset+2]   =  r;
+static void fillSpan32(uint8_t * destination, uint32_t hexColor, uint64_t count) {
+	uint64_t pixel = hexColor & 0x00FFFFFF;
+	_repStosq(destination, pixel | pixel << 32, count >> 1);
+	if (count & 1)
+		*(uint32_t *) (destination + (count - 1) * 4) = pixel;
 }
 
-void drawRectangle(uint32_t hexColor, uint64_t width, uint64_t height, uint64_t initial_pos_x, uint64_t initial_pos_y){
-	for(uint64_t y = initial_pos_y; y - initial_pos_y < height; y++){
-		for(uint64_t x = initial_pos_x; x - initial_pos_x < width; x++){
-			putPixel(hexColor, x, y);
-		}
+static void fillSpan24(uint8_t * destination, uint32_t hexColor, uint64_t count) {
+	union {
+		uint8_t bytes[24];
+		uint64_t words[3];
+	} pattern;
+	fillSpanBytes(pattern.bytes, hexColor, 8);	// 24 bpp, so 8 pixels fill it exactly
+
+	uint64_t * word = (uint64_t *) destination;
+	for (uint64_t i = count / 8; i > 0; i--, word += 3) {
+		word[0] = pattern.words[0];
+		word[1] = pattern.words[1];
+		word[2] = pattern.words[2];
 	}
+	fillSpanBytes((uint8_t *) word, hexColor, count % 8);
 }
 
-void drawCircle(uint32_t hexColor, uint64_t topLeftX, uint64_t topLeftY, uint64_t diameter) {
-    int64_t radius = diameter / 2;
-    int64_t centerX = topLeftX + radius;
-    int64_t centerY = topLeftY + radius;
-    
-    for (int64_t y = -radius; y < radius; y++) {
-        for (int64_t x = -radius; x < radius; x++) {
-            if (x * x + y * y <= radius * radius) {
-                putPixel(hexColor, centerX + x, centerY + y);
-            }
-        }
-    }
+static void copySpanQwords(uint8_t * destination, const uint8_t * source, uint64_t length) {
+	_repMovsq(destination, source, length / 8);
+	_repMovsb(destination + (length & ~7UL), source + (length & ~7UL), length % 8);
 }
 
+static void copySpanBytes(uint8_t * destination, const uint8_t * source, uint64_t length) {
+	_repMovsb(destination, source, length);
+}
 
-void fillVideoMemory(uint32_t hexColor) {
-	uint8_t * framebuffer = (uint8_t * )(unsigned long long)(VBE_mode_info->framebuffer);
-	uint16_t width = getWindowWidth();
+static FillSpan fillSpan = fillSpanBytes;
+static CopySpan copySpan = copySpanQwords;
+
+void initVideo(void) {
+	if (VBE_mode_info->bpp == 32)
+		fillSpan = fillSpan32;
+	else if (VBE_mode_info->bpp == 24)
+		fillSpan = fillSpan24;
+	if (_cpuidExtendedFeatures() & CPUID_ERMS)
+		copySpan = copySpanBytes;
+}
+
+/*
+ * Optional shadow buffer in RAM (initBackBuffer). The framebuffer is
+ * uncached or write-combining memory, so with it every primitive draws into
+ * RAM and only touches the framebuffer to copy the spans that changed. Each
+ * row keeps one dirty span [start, end), grown to cover everything drawn on
+ * it since the last flush. Flushes happen at the end of each console write,
+ * from the boot CPU's timer at most VIDEO_FLUSH_TICKS after the first change,
+ * and on the flush_video syscall.
+ *
+ * The back buffer is a ring of rows: screen row y lives in buffer row
+ * (y + originRow) % height, so scrolling moves originRow and clears the rows
+ * coming in at the bottom instead of moving every pixel up (panning, like the
+ * VBE display start would, but that one needs the BIOS). Each buffer row
+ * remembers the color it was last filled with and the span drawn over it
+ * since, and each screen row remembers the same of what the framebuffer
+ * shows. After a scroll a screen row is only copied over the union of both
+ * spans, so flushing a scrolled listing costs about as much as its text.
+ */
+typedef struct {
+	uint32_t base;		// color the whole row was last filled with
+	uint16_t inkStart;	// [inkStart, inkEnd) may have been drawn over since
+	uint16_t inkEnd;
+} RowContents;
+
+static uint8_t * backBuffer = NULL;
+static RowContents * bufferRows = NULL;	// by buffer row
+static RowContents * shownRows = NULL;	// by screen row, as of the last flush
+static uint16_t originRow = 0;			// buffer row shown at the top of the screen
+static uint16_t * dirtyStart = NULL;
+static uint16_t * dirtyEnd = NULL;
+static uint16_t dirtyTop = UINT16_MAX;	// rows [dirtyTop, dirtyBottom) may have dirty spans
+static uint16_t dirtyBottom = 0;
+static uint64_t dirtySince = 0;			// tick of the first change since the last flush
+
+static inline uint8_t * framebufferAddress(void) {
+	return (uint8_t * )(unsigned long long)(VBE_mode_info->framebuffer);
+}
+
+// Buffer row that holds screen row `y` (< height)
+static inline uint16_t bufferRow(uint64_t y) {
+	uint64_t row = y + originRow;
+	return row >= getWindowHeight() ? row - getWindowHeight() : row;
+}
+
+// Start of screen row `y` where the primitives draw
+static inline uint8_t * rowAddress(uint64_t y) {
+	if (!backBuffer)
+		return framebufferAddress() + y * VBE_mode_info->pitch;
+	return backBuffer + (uint64_t) bufferRow(y) * VBE_mode_info->pitch;
+}
+
+static void markDirtySpan(uint16_t row, uint16_t start, uint16_t end) {
+	if (start >= end)
+		return;
+	if (dirtyTop >= dirtyBottom) {
+		dirtySince = getTicks();
+		bootTimerDeadlinesChanged();	// its timer flushes this
+	}
+	if (row < dirtyTop) dirtyTop = row;
+	if (row >= dirtyBottom) dirtyBottom = row + 1;
+	if (start < dirtyStart[row]) dirtyStart[row] = start;
+	if (end > dirtyEnd[row]) dirtyEnd[row] = end;
+}
+
+// Records that the `width` x `height` rectangle at (x, y) was drawn over, clipped to the screen
+static void markDirty(uint64_t x, uint64_t y, uint64_t width, uint64_t height) {
+	if (!backBuffer || x >= getWindowWidth() || y >= getWindowHeight() || width == 0 || height == 0)
+		return;
+	uint16_t right = MIN(x + width, getWindowWidth());
+	uint16_t bottom = MIN(y + height, getWindowHeight());
+
+	for (uint16_t row = y; row < bottom; row++) {
+		markDirtySpan(row, x, right);
+		RowContents * contents = &bufferRows[bufferRow(row)];
+		if (x < contents->inkStart) contents->inkStart = x;
+		if (right > contents->inkEnd) contents->inkEnd = right;
+	}
+}
+
+// Records that screen rows [top, bottom) were just filled with `color`
+static void markFilled(uint16_t top, uint16_t bottom, uint32_t color) {
+	if (!backBuffer)
+		return;
+	for (uint16_t y = top; y < bottom; y++) {
+		RowContents * contents = &bufferRows[bufferRow(y)];
+		contents->base = color;
+		contents->inkStart = UINT16_MAX;
+		contents->inkEnd = 0;
+	}
+}
+
+// After moving originRow every screen row shows another buffer row: marks where the two can differ
+static void markScrolled(void) {
+	for (uint16_t y = 0; y < getWindowHeight(); y++) {
+		RowContents * now = &bufferRows[bufferRow(y)];
+		RowContents * shown = &shownRows[y];
+		if (now->base != shown->base)
+			markDirtySpan(y, 0, getWindowWidth());
+		else
+			markDirtySpan(y, MIN(now->inkStart, shown->inkStart), MAX(now->inkEnd, shown->inkEnd));
+	}
+}
+
+void initBackBuffer(void) {
+#ifndef NO_BACK_BUFFER
 	uint16_t height = getWindowHeight();
+	uint64_t bytes = ((uint64_t) VBE_mode_info->pitch * height + 7) & ~7UL;
+	uint8_t * memory = allocMemory(bytes + height * (2 * sizeof(RowContents) + 2 * sizeof(uint16_t)));
+	if (memory == NULL)
+		return;	// keeps drawing straight to the framebuffer
 
-	uint8_t b = (hexColor) & 0xFF, g = (hexColor >> 8) & 0xFF, r = (hexColor >> 16) & 0xFF;
-	uint64_t yoffset;
-	for (uint16_t y = 0; y < height; y++) {
-		yoffset = (y * VBE_mode_info->pitch);
-		for (uint16_t x = 0; x < width; x++) {
-			uint64_t offset = (x * ((VBE_mode_info->bpp) >> 3)) + yoffset;
-			framebuffer[offset] = b;
-			framebuffer[offset + 1] = g;
-			framebuffer[offset + 2] = r;
+	bufferRows = (RowContents *) (memory + bytes);
+	shownRows = bufferRows + height;
+	dirtyStart = (uint16_t *) (shownRows + height);
+	dirtyEnd = dirtyStart + height;
+	for (uint16_t row = 0; row < height; row++) {
+		// Whatever was printed so far could be anywhere on the row
+		bufferRows[row] = (RowContents) { 0, 0, getWindowWidth() };
+		shownRows[row] = bufferRows[row];
+		dirtyStart[row] = UINT16_MAX;
+		dirtyEnd[row] = 0;
+	}
+	copySpan(memory, framebufferAddress(), (uint64_t) VBE_mode_info->pitch * height);
+	originRow = 0;
+	backBuffer = memory;
+#endif
+}
+
+void flushVideo(void) {
+	if (!backBuffer || dirtyTop >= dirtyBottom)
+		return;
+
+	uint8_t * framebuffer = framebufferAddress();
+	uint8_t bytesPerPixel = getBytesPerPixel();
+	for (uint16_t row = dirtyTop; row < dirtyBottom; row++) {
+		if (dirtyStart[row] < dirtyEnd[row]) {
+			uint64_t offset = dirtyStart[row] * bytesPerPixel;
+			copySpan(framebuffer + (uint64_t) row * VBE_mode_info->pitch + offset, rowAddress(row) + offset, (dirtyEnd[row] - dirtyStart[row]) * bytesPerPixel);
+			shownRows[row] = bufferRows[bufferRow(row)];	// the rest of the row already matched
+			dirtyStart[row] = UINT16_MAX;
+			dirtyEnd[row] = 0;
 		}
 	}
+	dirtyTop = UINT16_MAX;
+	dirtyBottom = 0;
+}
+
+uint64_t nextVideoFlush(uint64_t tick) {
+	if (!backBuffer || dirtyTop >= dirtyBottom)
+		return UINT64_MAX;
+	return dirtySince + VIDEO_FLUSH_TICKS > tick ? dirtySince + VIDEO_FLUSH_TICKS : tick;
+}
+
+void flushVideoIfDue(uint64_t tick) {
+	if (nextVideoFlush(tick) <= tick)
+		flushVideo();
 }
 
 uint16_t getWindowHeight() {
@@ -109,40 +289,114 @@ uint16_t getWindowWidth() {
 	return VBE_mode_info->width;
 }
 
-void scrollVideoMemoryUp(uint16_t scroll, uint32_t fillColor) {
-	_cli();
+static inline void setPixel(uint32_t hexColor, uint64_t x, uint64_t y) {
+	uint8_t * pixel = rowAddress(y) + x * ((VBE_mode_info->bpp) >> 3);
+	pixel[0] = (hexColor) & 0xFF;
+	pixel[1] = (hexColor >> 8) & 0xFF;
+	pixel[2] = (hexColor >> 16) & 0xFF;
+}
 
-	uint8_t * framebuffer = (uint8_t * )(unsigned long long)(VBE_mode_info->framebuffer);
-	uint16_t width = getWindowWidth();
-	uint16_t height = getWindowHeight();
-	
-	uint8_t b = (fillColor) & 0xFF, g = (fillColor >> 8) & 0xFF, r = (fillColor >> 16) & 0xFF;
-
-	// Iterating over Y, then X
-	// -> Memory is contiguous in the framebuffer, increased cached hits, reduced tearing
-	uint64_t yoffset, ynoffset, offset, new_offset, xo;
-	for (uint16_t y = 0; y < height - scroll; y++) {
-		yoffset = (y * VBE_mode_info->pitch);
-		ynoffset = ((y + scroll) * VBE_mode_info->pitch);
-		for (uint16_t x = 0; x < width; x++) {
-			xo = (x * ((VBE_mode_info->bpp) >> 3));
-			offset = xo + yoffset;
-			new_offset = xo + ynoffset;
-			framebuffer[offset] = framebuffer[new_offset];
-			framebuffer[offset + 1] = framebuffer[new_offset + 1];
-			framebuffer[offset + 2] = framebuffer[new_offset + 2];
-		}
+void putPixel(uint32_t hexColor, uint64_t x, uint64_t y) {
+	if (x >= getWindowWidth() || y >= getWindowHeight())
+		return;
+	setPixel(hexColor, x, y);
+	markDirty(x, y, 1, 1);
+}
+
+uint8_t getBytesPerPixel(void) {
+	return VBE_mode_info->bpp >> 3;
+}
+
+void encodeColor(uint32_t hexColor, uint8_t * pixel) {
+	pixel[0] = (hexColor) & 0xFF;
+	pixel[1] = (hexColor >> 8) & 0xFF;
+	pixel[2] = (hexColor >> 16) & 0xFF;
+	if (getBytesPerPixel() == 4)
+		pixel[3] = 0;
+}
+
+void copyPixelRow(const uint8_t * pixels, uint64_t x, uint64_t y, uint64_t count) {
+	copySpan(rowAddress(y) + x * getBytesPerPixel(), pixels, count * getBytesPerPixel());
+	markDirty(x, y, count, 1);
+}
+
+void drawSpan(uint32_t hexColor, uint64_t x, uint64_t y, uint64_t length) {
+	if (x >= getWindowWidth() || y >= getWindowHeight() || length == 0)
+		return;
+	length = MIN(length, getWindowWidth() - x);
+	fillSpan(rowAddress(y) + x * getBytesPerPixel(), hexColor, length);
+	markDirty(x, y, length, 1);
+}
+
+void drawRectangle(uint32_t hexColor, uint64_t width, uint64_t height, uint64_t initial_pos_x, uint64_t initial_pos_y){
+	uint64_t bottom = MIN(initial_pos_y + height, getWindowHeight());
+	for(uint64_t y = initial_pos_y; y < bottom; y++){
+		drawSpan(hexColor, initial_pos_x, y, width);
 	}
+}
+
+/*
+ * Fills the pixels (x, y) of the diameter x diameter square with
+ * x^2 + y^2 <= radius^2, x and y in [-radius, radius) from the center, one
+ * span per row. Walking down from the middle row the half width `x` only
+ * shrinks, tracked with the error term radius^2 - x^2 - y^2 (as in the
+ * midpoint algorithm, but with the exact test so the shape does not change).
+ */
+void drawCircle(uint32_t hexColor, uint64_t topLeftX, uint64_t topLeftY, uint64_t diameter) {
+	int64_t radius = diameter / 2;
+	int64_t centerX = topLeftX + radius;
+	int64_t centerY = topLeftY + radius;
 
-	for (uint16_t y = height - scroll; y < height; y++) {
-		yoffset = (y * VBE_mode_info->pitch);
-		for (uint16_t x = 0; x < width; x++) {
-			offset = (x * ((VBE_mode_info->bpp) >> 3)) + yoffset;
-			framebuffer[offset] = b;
-			framebuffer[offset + 1] = g;
-			framebuffer[offset + 2] = r;
+	int64_t x = radius;
+	int64_t error = 0;
+	for (int64_t y = 0; y <= radius && radius > 0; y++) {
+		while (error < 0) {
+			error += 2 * x - 1;
+			x--;
 		}
+		uint64_t length = MIN(x, radius - 1) + x + 1;
+		if (y < radius)
+			drawSpan(hexColor, centerX - x, centerY + y, length);
+		if (y > 0)
+			drawSpan(hexColor, centerX - x, centerY - y, length);
+		error -= 2 * y + 1;
 	}
+}
+
+// Fills screen rows [top, bottom)
+static void fillRows(uint16_t top, uint16_t bottom, uint32_t hexColor) {
+	for (uint16_t y = top; y < bottom; y++)
+		fillSpan(rowAddress(y), hexColor, getWindowWidth());
+}
 
-	_sti();
+void fillVideoMemory(uint32_t hexColor) {
+	uint16_t width = getWindowWidth();
+	uint16_t height = getWindowHeight();
+	fillRows(0, height, hexColor);
+	markDirty(0, 0, width, height);
+	markFilled(0, height, hexColor);
+}
+
+// Restores the caller's interrupt state afterwards: a bare _sti() here re-enabled interrupts in the middle of syscalls
+static Spinlock scrollLock = NAMED_SPINLOCK_INIT("scroll");
+
+// With the back buffer this only clears the `scroll` rows coming in; without it, it moves the screen a row at a time
+void scrollVideoMemoryUp(uint16_t scroll, uint32_t fillColor) {
+	uint16_t height = getWindowHeight();
+	if (scroll > height)
+		scroll = height;
+
+	uint64_t flags = spinLockIrqSave(&scrollLock);
+	if (backBuffer) {
+		originRow = bufferRow(scroll);
+		fillRows(height - scroll, height, fillColor);
+		markFilled(height - scroll, height, fillColor);
+		markScrolled();
+	} else {
+		uint64_t bytes = getWindowWidth() * getBytesPerPixel();
+		for (uint16_t y = 0; y + scroll < height; y++)
+			copySpan(rowAddress(y), rowAddress(y + scroll), bytes);
+		fillRows(height - scroll, height, fillColor);
+	}
+	spinUnlockIrqRestore(&scrollLock, flags);
 }
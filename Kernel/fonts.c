@@ -8,6 +8,7 @@
 #include <fonts.h>
 #include <keyboard.h>
 #include <video.h>
+#include <lib.h>
 
 /* 
     Note: An attempt was made to use the Linux kernel's Solarize.12x29.psf (https://wiki.osdev.org/PC_Screen_Font). Now only the pain remains.
@@ -27,12 +28,31 @@
 
 #include "include/font_basic_8x8.h"
 
-#define FD_STDIN  0
-#define FD_STDOUT 1
-#define FD_STDERR 2
-
 #define MAX(a,b) ((a) > (b) ? (a) : (b))
 
+#define MAX_FONT_SIZE 10
+
+/*
+ * Glyph cache: for each (character, font size, text color, background color)
+ * it keeps the glyph's rows already scaled and in framebuffer pixel format,
+ * so rendering one is a memcpy per screen row. A glyph only has
+ * DEFAULT_GLYPH_SIZE_Y distinct rows, each repeated fontSize times on
+ * screen. Direct mapped: with one color pair, the printable characters never
+ * collide.
+ */
+#define GLYPH_CACHE_ENTRIES 128
+#define MAX_GLYPH_ROW_BYTES (DEFAULT_GLYPH_SIZE_X * MAX_FONT_SIZE * 4)
+
+typedef struct {
+    uint8_t fontSize;           // 0 while the entry is unused
+    char ascii;
+    uint32_t textColor;
+    uint32_t backgroundColor;
+    uint8_t rows[DEFAULT_GLYPH_SIZE_Y][MAX_GLYPH_ROW_BYTES];
+} CachedGlyph;
+
+static CachedGlyph glyphCache[GLYPH_CACHE_ENTRIES];
+
 static uint16_t glyphSizeX = DEFAULT_GLYPH_SIZE_X;
 static uint16_t glyphSizeY = DEFAULT_GLYPH_SIZE_Y;
 static uint16_t fontSize = 1;
@@ -48,7 +68,6 @@ static uint8_t dirty_line;
 
 static uint32_t text_color = DEFAULT_TEXT_COLOR;
 static uint32_t background_color = DEFAULT_BACKGROUND_COLOR;
-static uint8_t file_descriptor = FD_STDOUT;
 
 void setTextColor(uint32_t color) {
     text_color = color;
@@ -72,7 +91,6 @@ uint16_t getXBufferPosition(void) {
 
 static char buffer[64] = { '0' };
 
-static inline void renderFromBitmap(char * bitmap, uint64_t xBase, uint64_t yBase);
 static inline void renderAscii(char ascii, uint64_t x, uint64_t y);
 
 void showCursor(void);
@@ -84,25 +102,45 @@ static uint32_t uintToBase(uint64_t value, char * buffer, uint32_t base);
 static void printBase(uint64_t value, uint32_t base);
 static inline int64_t strlen(const char * str);
 
-// * Uses inline to avoid stack frames on hot paths *
-static inline void renderFromBitmap(char * bitmap, uint64_t xBase, uint64_t yBase) {
-    int xs, xo;
-    for (int x = 0; x < glyphSizeX * fontSize; x++) {
-        xs = xBase + x;
-        xo = x / fontSize;
-        for (int y = 0; y < glyphSizeY * fontSize; y++) {
-            // Read into char * slice and mask
-            putPixel(*(bitmap + (y / fontSize)) & (1 << xo) ? text_color : background_color, xs, yBase + y);
+// Expands the bitmap rows of `glyph` (a slice of the whole matrix) into its entry
+static void fillCachedGlyph(CachedGlyph * entry, char * glyph) {
+    uint8_t bytesPerPixel = getBytesPerPixel();
+    uint8_t foreground[4], background[4];
+    encodeColor(text_color, foreground);
+    encodeColor(background_color, background);
+
+    for (int row = 0; row < glyphSizeY; row++) {
+        uint8_t * pixel = entry->rows[row];
+        for (int x = 0; x < glyphSizeX * fontSize; x++, pixel += bytesPerPixel) {
+            uint8_t * color = glyph[row] & (1 << (x / fontSize)) ? foreground : background;
+            for (int i = 0; i < bytesPerPixel; i++)
+                pixel[i] = color[i];
         }
     }
 }
 
+static CachedGlyph * getCachedGlyph(char ascii) {
+    uint32_t colors = text_color * 31 + background_color * 17 + fontSize * 7;
+    CachedGlyph * entry = &glyphCache[(ascii + colors) % GLYPH_CACHE_ENTRIES];
+    if (entry->fontSize != fontSize || entry->ascii != ascii ||
+        entry->textColor != text_color || entry->backgroundColor != background_color) {
+        fillCachedGlyph(entry, bitmap + (ascii * glyphSizeY));
+        entry->fontSize = fontSize;
+        entry->ascii = ascii;
+        entry->textColor = text_color;
+        entry->backgroundColor = background_color;
+    }
+    return entry;
+}
+
 // * Uses inline to avoid stack frames on hot paths *
 // `x` and `y` are the TOP LEFT corner positions
 static inline void renderAscii(char ascii, uint64_t x, uint64_t y) {
-    if (ascii < 128) {
-        // The function only takes in a slice of the whole matrix
-        renderFromBitmap(bitmap + (ascii * glyphSizeY), x, y);
+    if (ascii >= 0) {
+        CachedGlyph * glyph = getCachedGlyph(ascii);
+        uint16_t width = glyphSizeX * fontSize;
+        for (int row = 0; row < glyphSizeY * fontSize; row++)
+            copyPixelRow(glyph->rows[row / fontSize], x, y + row, width);
     }
 }
 
@@ -143,40 +181,47 @@ void putChar(char ascii) {
     }
 }
 
-int32_t printToFd(int32_t fd, const char * string, int32_t count) {
-    if (fd != file_descriptor) {
-        switch (fd) {
-            case FD_STDIN:
-                int i = 0;
-                for ( ; i < count; i++ ) {
-                    addCharToBuffer(string[i], 1);
-                }
-                return i;
-            case FD_STDOUT:
-                text_color = DEFAULT_TEXT_COLOR;
-                background_color = DEFAULT_BACKGROUND_COLOR;
-                file_descriptor = fd;
-                break;
-            case FD_STDERR:
-                text_color = DEFAULT_ERROR_COLOR;
-                background_color = DEFAULT_BACKGROUND_COLOR;
-                file_descriptor = fd;
-                break;
-            default:
+static inline int isControlCharacter(char c) {
+    return c == NEW_LINE_CHAR || c == CARRIAGE_RETURN_CHAR || c == TABULATOR_CHAR;
+}
+
+// Prints `count` characters of `string` in the given colors, restoring the current ones afterwards.
+// Runs of printable characters are rendered back to back, checking the line wrap once per run instead of once per glyph
+void printColored(const char * string, uint64_t count, uint32_t textColor, uint32_t backgroundColor) {
+    uint32_t previousTextColor = text_color;
+    uint32_t previousBackgroundColor = background_color;
+    text_color = textColor;
+    background_color = backgroundColor;
+
+    uint16_t glyphWidth = glyphSizeX * fontSize;
+    uint16_t windowWidth = getWindowWidth();
+    uint64_t i = 0;
+
+    while (i < count) {
+        if (isControlCharacter(string[i])) {
+            putChar(string[i++]);
+            continue;
         }
-    }
 
-    int i = 0;
-    for ( ; i < count; i++ ) {
-        putChar(string[i]);
+        if (xBufferPosition + glyphWidth > windowWidth) {
+            newLine();
+        }
+
+        dirty_line = 1;
+        int32_t fit = (windowWidth - xBufferPosition) / glyphWidth;
+        for ( ; fit > 0 && i < count && !isControlCharacter(string[i]); fit--, i++) {
+            renderAscii(string[i], xBufferPosition, yBufferPosition);
+            xBufferPosition += glyphWidth;
+        }
     }
 
-    return i;
+    text_color = previousTextColor;
+    background_color = previousBackgroundColor;
 }
 
-// Prints `string` Null terminated string to `STDOUT`
+// Prints `string` Null terminated string in the current colors
 void print(const char * string) {
-    printToFd(FD_STDOUT, string, strlen(string));
+    printColored(string, strlen(string), text_color, background_color);
 }
 
 // Jumps to the next line, does not print an empty line
@@ -238,7 +283,7 @@ void hideCursor(void) {
 }
 
 uint8_t increaseFontSize(void) {
-    fontSize = fontSize > 9 ? fontSize : fontSize + 1;
+    fontSize = fontSize >= MAX_FONT_SIZE ? fontSize : fontSize + 1;
     maxGlyphSizeYOnLine =  dirty_line == 1 ? MAX(maxGlyphSizeYOnLine, glyphSizeY * fontSize) : (glyphSizeY * fontSize);
     scrollBufferPositionIfNeeded();
     return fontSize;
@@ -251,7 +296,7 @@ uint8_t decreaseFontSize(void) {
 }
 
 uint8_t setFontSize(int8_t size) {
-    fontSize = (size < 1 ? 1 : size > 10 ? 10 : size);
+    fontSize = (size < 1 ? 1 : size > MAX_FONT_SIZE ? MAX_FONT_SIZE : size);
     maxGlyphSizeYOnLine = dirty_line == 1 ? MAX(maxGlyphSizeYOnLine, glyphSizeY * fontSize) : (glyphSizeY * fontSize);
     return fontSize;
 }
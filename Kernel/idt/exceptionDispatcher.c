@@ -57,14 +57,9 @@ void printExceptionData(uint64_t * registers, int errorCode) {
 	print("Press r to go back to Shell");
 
 	char a;
-	// getKeyboardCharacter calls _hlt which triggers _sti
-	// so non-keyboard interrupts are disabled until the user confirms
-
-	picMasterMask(KEYBOARD_PIC_MASTER);
-	picSlaveMask(NO_INTERRUPTS);
+	// Only the faulting process waits for the user to confirm: getKeyboardCharacter blocks it,
+	// and the other CPUs (and processes) keep going, since the keyboard may be handled by any of them
 	while ((a = getKeyboardCharacter(0)) != 'r') {}
-	picMasterMask(KEYBOARD_PIC_MASTER & TIMER_PIC_MASTER);
-	picSlaveMask(NO_INTERRUPTS);
 
 	return ;
 }
\ No newline at end of file
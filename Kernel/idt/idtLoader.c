@@ -1,4 +1,7 @@
 #include <idtLoader.h>
+#include <lib.h>
+#include <apic.h>
+#include <time.h>
 
 #pragma pack(push) // save current alignment values into the compilers stack
 #pragma pack(1) // set alignment
@@ -18,6 +21,16 @@ typedef struct {
 
 DESCR_INT * idt = (DESCR_INT *) 0;
 
+// https://wiki.osdev.org/SYSENTER#AMD:_SYSCALL.2FSYSRET
+#define MSR_EFER	0xC0000080
+#define MSR_STAR	0xC0000081
+#define MSR_LSTAR	0xC0000082
+#define MSR_FMASK	0xC0000084
+
+#define EFER_SCE		0x01	// SYSCALL enable
+#define KERNEL_CS		0x08	// SYSCALL loads CS from STAR[47:32] and SS from CS + 8
+#define SYSCALL_FMASK	0x700	// rflags bits cleared on entry: TF, IF, DF
+
 static void setup_IDT_entry(int index, uint64_t offset);
 
 void load_idt() {
@@ -31,16 +44,44 @@ void load_idt() {
 	setup_IDT_entry(0x20, (uint64_t) &_irq00Handler); 
 	setup_IDT_entry(0x21, (uint64_t) &_irq01Handler);
 	setup_IDT_entry(0x80, (uint64_t) &_irq80Handler);
+	setup_IDT_entry(0x81, (uint64_t) &_irq81Handler);
+	setup_IDT_entry(APIC_TIMER_VECTOR, (uint64_t) &_apicTimerHandler);
+	setup_IDT_entry(APIC_RESCHEDULE_VECTOR, (uint64_t) &_rescheduleHandler);
+	setup_IDT_entry(APIC_AP_START_VECTOR, (uint64_t) &apLoader);
+	setup_IDT_entry(APIC_SPURIOUS_VECTOR, (uint64_t) &_spuriousHandler);
+
+	// A masked 8259 can still raise its spurious IRQ7 / IRQ15
+	setup_IDT_entry(0x27, (uint64_t) &_spuriousHandler);
+	setup_IDT_entry(0x2F, (uint64_t) &_spuriousHandler);
+
+	load_syscalls();
 
 	// Enable:
-	// IRQ0 -> TimerTick
+	// IRQ0 -> TimerTick, unless the local APIC timer drives the ticks (tickless)
 	// IRQ1 -> Keyboard
-	picMasterMask(KEYBOARD_PIC_MASTER & TIMER_PIC_MASTER);
-	picSlaveMask(NO_INTERRUPTS);
+	if (initIoApic()) {
+		// The IO-APIC takes over: the 8259 stays remapped but fully masked
+		picMasterMask(NO_INTERRUPTS);
+		picSlaveMask(NO_INTERRUPTS);
+		if (!isTickless())
+			ioapicRoute(TIMER_IRQ, 0x20);
+		ioapicRoute(KEYBOARD_IRQ, 0x21);
+	} else {
+		picMasterMask(isTickless() ? KEYBOARD_PIC_MASTER : KEYBOARD_PIC_MASTER & TIMER_PIC_MASTER);
+		picSlaveMask(NO_INTERRUPTS);
+	}
 			
 	_sti();
 }
 
+// Enables the SYSCALL instruction, entering the kernel at _syscallHandler
+void load_syscalls() {
+	_writeMSR(MSR_STAR, (uint64_t)KERNEL_CS << 32);
+	_writeMSR(MSR_LSTAR, (uint64_t) &_syscallHandler);
+	_writeMSR(MSR_FMASK, SYSCALL_FMASK);
+	_writeMSR(MSR_EFER, _readMSR(MSR_EFER) | EFER_SCE);
+}
+
 static void setup_IDT_entry(int index, uint64_t offset) {
 	idt[index].offset_l = offset & 0xFFFF;
 	idt[index].selector = 0x08;
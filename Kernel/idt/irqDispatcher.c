@@ -1,6 +1,9 @@
 #include <time.h>
 #include <stdint.h>
 #include <keyboard.h>
+#include <interruptStats.h>
+#include <interrupts.h>
+#include <apic.h>
 
 static uint8_t int_20();
 static uint8_t int_21();
@@ -10,13 +13,24 @@ static uint8_t (*interruptions[]) (void) = {
 	int_21
 };
 
+static uint64_t interruptCount[2] = { 0 };
+
 uint8_t irqDispatcher(uint64_t irq) {
 	if (irq < 2) {
+		interruptCount[irq]++;
 		return interruptions[irq]();
 	}
 	return 0;
 }
 
+void getInterruptStats(InterruptStats * stats) {
+	stats->timer = interruptCount[0];
+	stats->keyboard = interruptCount[1];
+	stats->ticks = getTicks();
+	stats->tickless = isTickless();
+	stats->keyboardCpu = ioapicAffinity(KEYBOARD_IRQ);
+}
+
 static uint8_t int_20() {
 	timer_handler();
 	return 0;
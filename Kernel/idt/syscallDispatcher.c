@@ -7,172 +7,162 @@
 #include <video.h>
 #include <time.h>
 #include <memoryManager.h>
+#include <slab.h>
+#include <process.h>
+#include <scheduler.h>
+#include <semaphore.h>
+#include <fileDescriptor.h>
+#include <console.h>
+#include <interrupts.h>
+#include <apic.h>
+#include <kernelLock.h>
+#include <cpu.h>
+#include <spinlock.h>
+#include <robustLock.h>
 
 extern int64_t register_snapshot[18];
 extern int64_t register_snapshot_taken;
 
-// @todo Note: Technically.. registers on the stack are modifiable (since its a struct pointer, not struct).
-int32_t syscallDispatcher(Registers *registers)
+typedef int64_t (*SyscallHandler)(uint64_t arg0, uint64_t arg1, uint64_t arg2, uint64_t arg3, uint64_t arg4);
+
+typedef struct
 {
-	switch (registers->rax)
-	{
-	case 3:
-		return sys_read(registers->rdi, (signed char *)registers->rsi, registers->rdx);
-	// Note: Register parameters are 64-bit
-	case 4:
-		return sys_write(registers->rdi, (char *)registers->rsi, registers->rdx);
-
-	case 0x80000000:
-		return sys_start_beep(registers->rdi);
-	case 0x80000001:
-		return sys_stop_beep();
-	case 0x80000002:
-		return sys_fonts_text_color(registers->rdi);
-	case 0x80000003:
-		return sys_fonts_background_color(registers->rdi);
-	case 0x80000004: /* Reserved for sys_set_italics */
-	case 0x80000005: /* Reserved for sys_set_bold */
-	case 0x80000006: /* Reserved for sys_set_underline */
-		return -1;
-	case 0x80000007:
-		return sys_fonts_decrease_size();
-	case 0x80000008:
-		return sys_fonts_increase_size();
-	case 0x80000009:
-		return sys_fonts_set_size((uint8_t)registers->rdi);
-	case 0x8000000A:
-		return sys_clear_screen();
-	case 0x8000000B:
-		return sys_clear_input_buffer();
-
-	case 0x80000010:
-		return sys_hour((int *)registers->rdi);
-	case 0x80000011:
-		return sys_minute((int *)registers->rdi);
-	case 0x80000012:
-		return sys_second((int *)registers->rdi);
-
-	case 0x80000019:
-		return sys_circle(registers->rdi, registers->rsi, registers->rdx, registers->rcx);
-	case 0x80000020:
-		return sys_rectangle(registers->rdi, registers->rsi, registers->rdx, registers->rcx, registers->r8);
-	case 0x80000021:
-		return sys_fill_video_memory(registers->rdi);
-
-	case 0x800000A0:
-		return sys_exec((int (*)(void))registers->rdi);
-
-	case 0x800000B0:
-		return sys_register_key((uint8_t)registers->rdi, (SpecialKeyHandler)registers->rsi);
-
-	case 0x800000C0:
-		return sys_window_width();
-	case 0x800000C1:
-		return sys_window_height();
-
-	case 0x800000D0:
-		return sys_sleep_milis(registers->rdi);
-
-	case 0x800000E0:
-		return sys_get_register_snapshot((int64_t *)registers->rdi);
-
-	case 0x800000F0:
-		return sys_get_character_without_display();
-
-	case 0x80000100:
-		return sys_get_mem_status((MemoryStatus *)registers->rdi);
-	case 0x80000101:
-		return (int64_t)sys_malloc(registers->rdi);
-	case 0x80000102:
-		return sys_free((void *)registers->rdi);
-
-	default:
-		return 0;
+	const char *name;
+	SyscallHandler handler;
+	uint8_t argc;
+	uint8_t flags;
+} SyscallEntry;
+
+// Handlers take their arguments straight from the registers they arrive in (rdi, rsi, rdx, rcx/r10, r8).
+// Each gets a thunk with the table's signature that calls it through its own prototype with its
+// first `argc` of them, so an argc in syscallTable.h that does not match the handler fails to compile.
+#define SYSCALL_ARGS_0
+#define SYSCALL_ARGS_1 arg0
+#define SYSCALL_ARGS_2 arg0, arg1
+#define SYSCALL_ARGS_3 arg0, arg1, arg2
+#define SYSCALL_ARGS_4 arg0, arg1, arg2, arg3
+#define SYSCALL_ARGS_5 arg0, arg1, arg2, arg3, arg4
+
+#define SYSCALL_THUNK(number, name, argc, flags) \
+	static int64_t thunk_##name(uint64_t arg0, uint64_t arg1, uint64_t arg2, uint64_t arg3, uint64_t arg4) \
+	{ \
+		return sys_##name(SYSCALL_ARGS_##argc); \
 	}
+
+SYSCALL_LIST(SYSCALL_THUNK)
+
+#define SYSCALL_ENTRY(number, name, argc, flags) [number] = {#name, thunk_##name, argc, flags},
+
+// Dense: the syscall number is the index (see syscallTable.h)
+static const SyscallEntry syscallTable[SYSCALL_COUNT] = {
+	SYSCALL_LIST(SYSCALL_ENTRY)
+};
+
+static uint64_t syscallCalls[SYSCALL_COUNT];
+static uint64_t syscallCycles[SYSCALL_COUNT];
+
+// Common entry for both paths; called directly by _syscallHandler (SYSCALL)
+int64_t syscallDispatch(uint64_t arg0, uint64_t arg1, uint64_t arg2, uint64_t arg3, uint64_t arg4, uint64_t number)
+{
+	if (number >= SYSCALL_COUNT)
+		return -1;
+
+	kernelLock();
+	uint64_t start = _rdtsc();
+	int64_t result = syscallTable[number].handler(arg0, arg1, arg2, arg3, arg4);
+	syscallCycles[number] += _rdtsc() - start;
+	syscallCalls[number]++;
+	kernelUnlock();
+
+	return result;
+}
+
+// int 0x80 entry: arguments come from the registers saved by _irq80Handler
+int64_t syscallDispatcher(Registers *registers)
+{
+	return syscallDispatch(registers->rdi, registers->rsi, registers->rdx, registers->rcx, registers->r8, registers->rax);
 }
 
 // ==================================================================
 // Linux syscalls
 // ==================================================================
 
-int32_t sys_write(int32_t fd, char *__user_buf, int32_t count)
+// fds are looked up in the running process' table and go straight to their device
+int64_t sys_write(uint64_t fd, uint64_t __user_buf, uint64_t count)
 {
-	return printToFd(fd, __user_buf, count);
+	return fdWrite((int32_t)fd, (const char *)__user_buf, count);
 }
 
-int32_t sys_read(int32_t fd, signed char *__user_buf, int32_t count)
+int64_t sys_read(uint64_t fd, uint64_t __user_buf, uint64_t count)
 {
-	int32_t i;
-	int8_t c;
-	for (i = 0; i < count && (c = getKeyboardCharacter(AWAIT_RETURN_KEY | SHOW_BUFFER_WHILE_TYPING)) != EOF; i++)
-	{
-		*(__user_buf + i) = c;
-	}
-	return i;
+	return fdRead((int32_t)fd, (signed char *)__user_buf, count);
 }
 
 // ==================================================================
 // Custom system calls
 // ==================================================================
 
-int32_t sys_start_beep(uint32_t nFrequence)
+int64_t sys_start_beep(uint64_t nFrequence)
 {
-	play_sound(nFrequence);
+	play_sound((uint32_t)nFrequence);
 	return 0;
 }
 
-int32_t sys_stop_beep(void)
+int64_t sys_stop_beep(void)
 {
 	setSpeaker(SPEAKER_OFF);
 	return 0;
 }
 
-int32_t sys_fonts_text_color(uint32_t color)
+// Colors of the console's standard output stream (stderr keeps its own), and of keyboard echo
+int64_t sys_fonts_text_color(uint64_t color)
 {
-	setTextColor(color);
+	getConsoleStream(FD_STDOUT)->textColor = (uint32_t)color;
+	setTextColor((uint32_t)color);
 	return 0;
 }
 
-int32_t sys_fonts_background_color(uint32_t color)
+int64_t sys_fonts_background_color(uint64_t color)
 {
-	setBackgroundColor(color);
+	getConsoleStream(FD_STDOUT)->backgroundColor = (uint32_t)color;
+	setBackgroundColor((uint32_t)color);
 	return 0;
 }
 
-int32_t sys_fonts_decrease_size(void)
+int64_t sys_fonts_decrease_size(void)
 {
 	return decreaseFontSize();
 }
 
-int32_t sys_fonts_increase_size(void)
+int64_t sys_fonts_increase_size(void)
 {
 	return increaseFontSize();
 }
 
-int32_t sys_fonts_set_size(uint8_t size)
+int64_t sys_fonts_set_size(uint64_t size)
 {
-	return setFontSize(size);
+	return setFontSize((uint8_t)size);
 }
 
-int32_t sys_clear_screen(void)
+int64_t sys_clear_screen(void)
 {
 	clear();
 	return 0;
 }
 
-int32_t sys_clear_input_buffer(void)
+int64_t sys_clear_input_buffer(void)
 {
 	while (clearBuffer() != 0)
 		;
 	return 0;
 }
 
-uint16_t sys_window_width(void)
+int64_t sys_window_width(void)
 {
 	return getWindowWidth();
 }
 
-uint16_t sys_window_height(void)
+int64_t sys_window_height(void)
 {
 	return getWindowHeight();
 }
@@ -181,21 +171,21 @@ uint16_t sys_window_height(void)
 // Date system calls
 // ==================================================================
 
-int32_t sys_hour(int *hour)
+int64_t sys_hour(uint64_t hour)
 {
-	*hour = getHour();
+	*(int *)hour = getHour();
 	return 0;
 }
 
-int32_t sys_minute(int *minute)
+int64_t sys_minute(uint64_t minute)
 {
-	*minute = getMinute();
+	*(int *)minute = getMinute();
 	return 0;
 }
 
-int32_t sys_second(int *second)
+int64_t sys_second(uint64_t second)
 {
-	*second = getSecond();
+	*(int *)second = getSecond();
 	return 0;
 }
 
@@ -203,21 +193,21 @@ int32_t sys_second(int *second)
 // Draw system calls
 // ==================================================================
 
-int32_t sys_circle(uint32_t hexColor, uint64_t topLeftX, uint64_t topLeftY, uint64_t diameter)
+int64_t sys_circle(uint64_t hexColor, uint64_t topLeftX, uint64_t topLeftY, uint64_t diameter)
 {
-	drawCircle(hexColor, topLeftX, topLeftY, diameter);
+	drawCircle((uint32_t)hexColor, topLeftX, topLeftY, diameter);
 	return 0;
 }
 
-int32_t sys_rectangle(uint32_t color, uint64_t width_pixels, uint64_t height_pixels, uint64_t initial_pos_x, uint64_t initial_pos_y)
+int64_t sys_rectangle(uint64_t color, uint64_t width_pixels, uint64_t height_pixels, uint64_t initial_pos_x, uint64_t initial_pos_y)
 {
-	drawRectangle(color, width_pixels, height_pixels, initial_pos_x, initial_pos_y);
+	drawRectangle((uint32_t)color, width_pixels, height_pixels, initial_pos_x, initial_pos_y);
 	return 0;
 }
 
-int32_t sys_fill_video_memory(uint32_t hexColor)
+int64_t sys_fill_video_memory(uint64_t hexColor)
 {
-	fillVideoMemory(hexColor);
+	fillVideoMemory((uint32_t)hexColor);
 	return 0;
 }
 
@@ -225,7 +215,7 @@ int32_t sys_fill_video_memory(uint32_t hexColor)
 // Custom exec system call
 // ==================================================================
 
-int32_t sys_exec(int32_t (*fnPtr)(void))
+int64_t sys_exec(uint64_t fnPtr)
 {
 	clear();
 
@@ -236,7 +226,13 @@ int32_t sys_exec(int32_t (*fnPtr)(void))
 	SpecialKeyHandler map[F12_KEY - ESCAPE_KEY + 1] = {0};
 	clearKeyFnMapNonKernel(map); // avoid """processes/threads/apps""" registering keys across each other over time. reset the map every time
 
-	int32_t aux = fnPtr();
+	// The program runs inside this syscall, so let the timer preempt it and other CPUs into the kernel
+	// like any other process code
+	kernelUnlock();
+	_sti();
+	int32_t aux = ((int32_t (*)(void))fnPtr)();
+	_cli();
+	kernelLock();
 
 	restoreKeyFnMapNonKernel(map);
 	setFontSize(fontSize);
@@ -251,26 +247,80 @@ int32_t sys_exec(int32_t (*fnPtr)(void))
 // Custom keyboard system calls
 // ==================================================================
 
-int32_t sys_register_key(uint8_t scancode, SpecialKeyHandler fn)
+int64_t sys_register_key(uint64_t scancode, uint64_t fn)
 {
-	registerSpecialKey(scancode, fn, 0);
+	registerSpecialKey((uint8_t)scancode, (SpecialKeyHandler)fn, 0);
 	return 0;
 }
 
 // ==================================================================
 // Sleep system calls
 // ==================================================================
-int32_t sys_sleep_milis(uint32_t milis)
+int64_t sys_sleep_milis(uint64_t milis)
 {
-	sleepTicks((milis * SECONDS_TO_TICKS) / 1000);
+	sleepTicks(((uint64_t)(uint32_t)milis * TIMER_FREQUENCY + 999) / 1000); // rounded up, so a short sleep still sleeps
 	return 0;
 }
 
+// Fills `ts` with the time of `clockId`. Returns 0, or -1 for an unknown clock
+int64_t sys_clock_gettime(uint64_t clockId, uint64_t tsArg)
+{
+	Timespec *ts = (Timespec *)tsArg;
+	if ((uint32_t)clockId != CLOCK_MONOTONIC || ts == NULL)
+		return -1;
+
+	uint64_t nanoseconds = monotonicNanoseconds();
+	ts->seconds = nanoseconds / NANOSECONDS_PER_SECOND;
+	ts->nanoseconds = nanoseconds % NANOSECONDS_PER_SECOND;
+	return 0;
+}
+
+int64_t sys_get_interrupt_stats(uint64_t stats)
+{
+	if (stats == 0)
+		return -1;
+	getInterruptStats((InterruptStats *)stats);
+	return 0;
+}
+
+int64_t sys_set_irq_affinity(uint64_t irq, uint64_t apicId)
+{
+	return ioapicSetAffinity((uint8_t)irq, (uint8_t)apicId);
+}
+
+int64_t sys_get_cpu_stats(uint64_t info, uint64_t maxEntries)
+{
+	if (info == 0)
+		return -1;
+	return getCpuStats((CpuInfo *)info, (uint32_t)maxEntries);
+}
+
+int64_t sys_get_lock_stats(uint64_t info, uint64_t maxEntries)
+{
+	if (info == 0)
+		return -1;
+	return getLockStats((LockInfo *)info, (uint32_t)maxEntries);
+}
+
+// Copies what the caller drew to the screen now instead of on the next timer flush
+int64_t sys_flush_video(void)
+{
+	flushVideo();
+	return 0;
+}
+
+int64_t sys_register_robust_lock(uint64_t lock)
+{
+	return registerRobustLock((volatile pid_t *)lock);
+}
+
 // ==================================================================
 // Register snapshot system calls
 // ==================================================================
-int32_t sys_get_register_snapshot(int64_t *registers)
+int64_t sys_get_register_snapshot(uint64_t snapshot)
 {
+	int64_t *registers = (int64_t *)snapshot;
+
 	if (register_snapshot_taken == 0)
 		return 0;
 
@@ -284,28 +334,199 @@ int32_t sys_get_register_snapshot(int64_t *registers)
 	return 1;
 }
 
-int32_t sys_get_character_without_display(void)
+int64_t sys_get_character_without_display(void)
 {
 	return getKeyboardCharacter(0);
 }
 
+// ==================================================================
+// Syscall table introspection
+// ==================================================================
+int64_t sys_abi_version(void)
+{
+	return SYSCALL_ABI_VERSION;
+}
+
+// Does nothing, to measure the cost of the syscall path itself
+int64_t sys_null(void)
+{
+	return 0;
+}
+
+int64_t sys_get_syscall_stats(uint64_t statsArg, uint64_t maxEntries)
+{
+	SyscallStats *stats = (SyscallStats *)statsArg;
+	if (stats == NULL)
+		return -1;
+
+	uint32_t count = (uint32_t)maxEntries < SYSCALL_COUNT ? (uint32_t)maxEntries : SYSCALL_COUNT;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const char *name = syscallTable[i].name;
+		uint32_t j = 0;
+		for (; name[j] && j < SYSCALL_NAME_LENGTH - 1; j++)
+			stats[i].name[j] = name[j];
+		stats[i].name[j] = 0;
+
+		stats[i].number = i;
+		stats[i].argc = syscallTable[i].argc;
+		stats[i].flags = syscallTable[i].flags;
+		stats[i].calls = syscallCalls[i];
+		stats[i].cycles = syscallCycles[i];
+	}
+
+	return count;
+}
+
 // ==================================================================
 // Memory management system calls
 // ==================================================================
 
-int32_t sys_get_mem_status(MemoryStatus *memStatus)
+int64_t sys_get_mem_status(uint64_t memStatus)
 {
-	getMemoryStatus(memStatus);
+	getMemoryStatus((MemoryStatus *)memStatus);
+	getSlabStatus((MemoryStatus *)memStatus);
 	return 0;
 }
 
-void *sys_malloc(int size)
+int64_t sys_malloc(uint64_t size)
 {
-	return allocMemory(size);
+	return (int64_t)allocMemory(size);
 }
 
-int32_t sys_free(void *ptr)
+int64_t sys_free(uint64_t ptr)
 {
-	freeMemory(ptr);
+	freeMemory((void *)ptr);
 	return 0;
 }
+
+int64_t sys_realloc(uint64_t ptr, uint64_t size)
+{
+	return (int64_t)reallocMemory((void *)ptr, size);
+}
+
+int64_t sys_calloc(uint64_t count, uint64_t size)
+{
+	if (count != 0 && size > UINT64_MAX / count)
+		return 0;
+
+	void *ptr = allocMemory(count * size);
+	if (ptr)
+		memset(ptr, 0, count * size);
+	return (int64_t)ptr;
+}
+
+// ==================================================================
+// Process system calls
+// ==================================================================
+
+int64_t sys_create_process(uint64_t name, uint64_t entry, uint64_t argc, uint64_t argv)
+{
+	return createProcess((const char *)name, (ProcessEntry)entry, argc, (char **)argv, getCurrentPid());
+}
+
+int64_t sys_getpid(void)
+{
+	return getCurrentPid();
+}
+
+int64_t sys_yield(void)
+{
+	yield();
+	return 0;
+}
+
+int64_t sys_kill(uint64_t pid)
+{
+	return killProcess((pid_t)pid);
+}
+
+int64_t sys_waitpid(uint64_t pid, uint64_t status)
+{
+	return waitProcess((pid_t)pid, (int64_t *)status);
+}
+
+int64_t sys_block(uint64_t pid)
+{
+	return blockProcess((pid_t)pid);
+}
+
+int64_t sys_unblock(uint64_t pid)
+{
+	return unblockProcess((pid_t)pid);
+}
+
+int64_t sys_nice(uint64_t pid, uint64_t priority)
+{
+	return niceProcess((pid_t)pid, (uint8_t)priority);
+}
+
+int64_t sys_get_processes(uint64_t info, uint64_t maxEntries)
+{
+	return getProcesses((ProcessInfo *)info, (uint32_t)maxEntries);
+}
+
+int64_t sys_exit(uint64_t code)
+{
+	exitProcess((int64_t)code);
+	return 0;
+}
+
+int64_t sys_context_switches(void)
+{
+	return getContextSwitches();
+}
+
+// ==================================================================
+// Semaphore system calls
+// ==================================================================
+
+int64_t sys_sem_open(uint64_t name, uint64_t initialValue)
+{
+	return semOpen((const char *)name, (uint32_t)initialValue);
+}
+
+int64_t sys_sem_wait(uint64_t id)
+{
+	return semWait((sem_t)id);
+}
+
+int64_t sys_sem_post(uint64_t id)
+{
+	return semPost((sem_t)id);
+}
+
+int64_t sys_sem_close(uint64_t id)
+{
+	return semClose((sem_t)id);
+}
+
+// ==================================================================
+// File descriptor system calls
+// ==================================================================
+
+int64_t sys_pipe(uint64_t fds)
+{
+	return fdPipe((int32_t *)fds);
+}
+
+int64_t sys_close(uint64_t fd)
+{
+	return fdClose((int32_t)fd);
+}
+
+int64_t sys_dup(uint64_t fd)
+{
+	return fdDup((int32_t)fd);
+}
+
+int64_t sys_dup2(uint64_t fd, uint64_t target)
+{
+	return fdDup2((int32_t)fd, (int32_t)target);
+}
+
+int64_t sys_open(uint64_t name)
+{
+	return fdOpen((const char *)name);
+}
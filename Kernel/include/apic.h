@@ -0,0 +1,69 @@
+#ifndef APIC_H
+#define APIC_H
+
+#include <stdint.h>
+
+#define APIC_TIMER_VECTOR       0x30    // tickless timer of the boot CPU
+#define APIC_RESCHEDULE_VECTOR  0x31    // reschedule IPIs, and the quantum timer of the other CPUs
+#define APIC_AP_START_VECTOR    0x32    // takes a parked core into the kernel
+#define APIC_SPURIOUS_VECTOR    0xF8    // as set up by Pure64
+
+/*
+ * Maps the local APIC at the address Pure64 left in its info map and sets its
+ * timer to one-shot mode (divide by 16), masked.
+ * Returns 1, or 0 if the machine has no local APIC.
+ */
+uint8_t initLocalApic(void);
+
+/*
+ * ID of the local APIC of the CPU running this code.
+ */
+uint8_t lapicId(void);
+
+/*
+ * Signals end of interrupt to the local APIC.
+ */
+void lapicEOI(void);
+
+/*
+ * Starts a one-shot countdown of `count` APIC timer ticks (0 stops it), and
+ * returns how many are left of the current one.
+ */
+void lapicTimerStart(uint32_t count);
+uint32_t lapicTimerRemaining(void);
+
+/*
+ * Lets the timer raise `vector` when the countdown ends / stops it.
+ */
+void lapicTimerUnmask(uint8_t vector);
+void lapicTimerMask(void);
+
+/*
+ * Sends a fixed interrupt with `vector` to the CPU whose local APIC is `apicId`.
+ */
+void lapicSendIpi(uint8_t apicId, uint8_t vector);
+
+/*
+ * Masks every pin of the IO-APIC that handles the ISA IRQs and makes
+ * interrupts.asm signal EOI to the local APIC instead of the 8259.
+ * Returns 1, or 0 if there is no usable IO-APIC (the 8259 keeps working).
+ */
+uint8_t initIoApic(void);
+
+/*
+ * Delivers ISA `irq` as `vector` to this CPU. Returns 1, or 0 if it can't.
+ */
+uint8_t ioapicRoute(uint8_t irq, uint8_t vector);
+
+/*
+ * Steers an already routed `irq` to the CPU whose local APIC is `apicId`,
+ * which must have run initLocalApic. Returns 0, or -1 on failure.
+ */
+int8_t ioapicSetAffinity(uint8_t irq, uint8_t apicId);
+
+/*
+ * APIC ID an `irq` is delivered to, or -1 if it is not routed through the IO-APIC.
+ */
+int16_t ioapicAffinity(uint8_t irq);
+
+#endif
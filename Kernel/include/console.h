@@ -0,0 +1,29 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <stdint.h>
+#include <device.h>
+
+/*
+ * One console output stream (stdout, stderr). Each keeps its own colors, so
+ * interleaving them never touches the other's, and parses its own ANSI
+ * "\e[...m" sequences even when they arrive split across writes.
+ */
+typedef struct {
+    uint32_t textColor;
+    uint32_t backgroundColor;
+    uint32_t defaultTextColor;  // restored by "\e[0m"
+    uint8_t  escapeState;
+    uint8_t  escapeProp;
+} ConsoleStream;
+
+extern const Device consoleDevice;     // context: a ConsoleStream
+extern const Device keyboardDevice;    // reads typed lines; writes are typed into the keyboard buffer
+extern const Device nullDevice;        // reads end of file, swallows writes
+
+/*
+ * Returns the console stream for FD_STDOUT or FD_STDERR, NULL for anything else.
+ */
+ConsoleStream *getConsoleStream(int32_t stream);
+
+#endif
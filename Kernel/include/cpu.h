@@ -0,0 +1,69 @@
+#ifndef CPU_H
+#define CPU_H
+
+#include <stdint.h>
+#include <cpuInfo.h>
+#include <process.h>
+#include <scheduler.h>
+
+#define BOOT_CPU 0  // index of the CPU that runs main
+
+/*
+ * Per-CPU data, reached through the GS base of each CPU (getCpu).
+ * Everything runs in ring 0 on Pure64's GDT and interrupts never switch
+ * stacks, so there is no per-CPU GDT or TSS: a CPU is defined by its local
+ * APIC, what it is running, and its boot stack.
+ */
+typedef struct Cpu {
+    struct Cpu          *self;              // GS:0, read by getCpu
+    uint8_t             index;
+    uint8_t             apicId;
+    volatile uint8_t    online;
+    volatile uint8_t    reschedulePending;  // a reschedule IPI is on its way
+    uint32_t            lockDepth;          // kernel lock nesting, see kernelLock.h
+
+    Process             *current;
+    Process             *idle;
+    Process             *previous;          // switched out, until the handler is off its stack (finishSwitch)
+    uint32_t            quantumLeft;
+    uint64_t            lastTick;           // last time its ticks were accounted
+    RunQueue            runQueue;
+
+    uint64_t            busyTicks;
+    uint64_t            idleTicks;
+    uint64_t            dispatches;
+
+    uint8_t             *stack;             // used until the first switch to a process
+} Cpu;
+
+/*
+ * The CPU running the caller. Only meaningful after initBootCpu.
+ */
+Cpu *getCpu(void);
+
+Cpu *getCpuByIndex(uint8_t index);
+uint8_t getCpuCount(void);  // online CPUs
+
+/*
+ * Sets up the per-CPU data of the boot CPU. Must be the first thing main does.
+ */
+void initBootCpu(void);
+
+/*
+ * Wakes every core Pure64 parked, each with its own idle process, and lets
+ * it join the scheduler. Needs the local APIC timer (for their quanta), the
+ * IDT and the process table to be up. Returns the number of CPUs online.
+ */
+uint8_t startApplicationProcessors(void);
+
+/*
+ * Makes `cpu` go through the scheduler as soon as possible.
+ */
+void sendReschedule(Cpu *cpu);
+
+/*
+ * Fills `info` with up to `maxEntries` online CPUs and returns how many were filled.
+ */
+uint32_t getCpuStats(CpuInfo *info, uint32_t maxEntries);
+
+#endif
@@ -5,4 +5,7 @@
 
 void toggleCursor(void);
 
+// Tick at which the cursor blinks next after `tick`, UINT64_MAX while nobody is typing
+uint64_t nextCursorToggle(uint64_t tick);
+
 #endif
\ No newline at end of file
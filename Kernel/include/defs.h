@@ -20,12 +20,27 @@
 #define ACS_STACK       (ACS_PRESENT | ACS_DSEG | ACS_WRITE)
 
 //Memory
+#define MAX_SLAB_CACHES  16
+#define SLAB_NAME_LENGTH 16
+
+typedef struct {
+    char     name[SLAB_NAME_LENGTH];
+    uint32_t objectSize;
+    uint32_t slabs;          // slabs owned by the cache
+    uint32_t objects;        // object slots across all slabs
+    uint32_t objectsInUse;
+    uint64_t allocs;
+    uint64_t frees;
+} SlabCacheStatus;
+
 typedef struct {
-    uint32_t total;  
-    uint32_t used;   
-    uint32_t free;    
+    uint64_t total;  
+    uint64_t used;   
+    uint64_t free;    
     void    *base;    
     void    *end;     
+    uint32_t slabCacheCount;
+    SlabCacheStatus slabCaches[MAX_SLAB_CACHES];
 } MemoryStatus;
 
 #endif
\ No newline at end of file
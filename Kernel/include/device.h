@@ -0,0 +1,19 @@
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#include <stdint.h>
+
+/*
+ * A device is what a file descriptor points to: a set of methods plus the
+ * context they run on (a pipe, a console stream...). Methods left NULL make
+ * that operation fail with -1 (read, write) or do nothing (open, close).
+ */
+typedef struct Device {
+    const char *name;
+    int64_t (*read)(void *context, uint8_t *buffer, uint64_t count);
+    int64_t (*write)(void *context, const uint8_t *buffer, uint64_t count);
+    void    (*open)(void *context);     // one more fd refers to `context`
+    void    (*close)(void *context);    // one fd referring to `context` went away
+} Device;
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef FILE_DESCRIPTOR_H
+#define FILE_DESCRIPTOR_H
+
+#include <stdint.h>
+#include <device.h>
+
+#define MAX_FDS 16
+
+#define FD_STDIN  0
+#define FD_STDOUT 1
+#define FD_STDERR 2
+
+// A closed fd has no device. Redirecting one is just copying these two pointers
+typedef struct {
+    const Device *device;
+    void         *context;
+} FileDescriptor;
+
+/*
+ * Fills a new process' table: a copy of `inherited` (opening every device
+ * again), or keyboard, console and console error on fds 0-2 if it is NULL.
+ */
+void initFileDescriptors(FileDescriptor *fds, const FileDescriptor *inherited);
+
+/*
+ * Closes every fd in `fds`. Called when a process exits.
+ */
+void closeFileDescriptors(FileDescriptor *fds);
+
+/*
+ * Operations on the running process' table. All return -1 on a bad fd.
+ */
+int64_t fdRead(int32_t fd, void *buffer, uint64_t count);
+int64_t fdWrite(int32_t fd, const void *buffer, uint64_t count);
+int32_t fdClose(int32_t fd);
+int32_t fdDup(int32_t fd);              // returns the lowest free fd
+int32_t fdDup2(int32_t fd, int32_t target);
+int32_t fdPipe(int32_t fds[2]);         // fds[0] reads, fds[1] writes
+int32_t fdOpen(const char *name);       // "keyboard", "console", "error" or "null"; returns the lowest free fd
+
+#endif
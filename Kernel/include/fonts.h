@@ -19,7 +19,7 @@
 
 void putChar(char ascii);
 void print(const char * string);
-int32_t printToFd(int32_t fd, const char * string, int32_t count);
+void printColored(const char * string, uint64_t count, uint32_t textColor, uint32_t backgroundColor);
 void newLine();
 void printDec(uint64_t value);
 void printHex(uint64_t value);
@@ -8,4 +8,10 @@
 
 void load_idt();
 
+/*
+ * Points the SYSCALL instruction at _syscallHandler. The MSRs are per CPU, so
+ * every application processor calls it too; the IDT itself is shared.
+ */
+void load_syscalls();
+
 #endif
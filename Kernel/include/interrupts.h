@@ -7,10 +7,17 @@
 #define INTERRUPS_H
 
 #include <stdint.h>
+#include <interruptStats.h>
 
 extern void (*_irq00Handler) (void);
 extern void (*_irq01Handler) (void);
+extern void (*_apicTimerHandler) (void);
+extern void (*_spuriousHandler) (void);
+extern void (*_rescheduleHandler) (void);
+extern void (*apLoader) (void);    // Kernel/loader.asm
 extern void (*_irq80Handler) (void);
+extern void (*_syscallHandler) (void);
+extern void (*_irq81Handler) (void);
 
 extern void (*_exceptionHandler00) (void);
 extern void (*_exceptionHandler06) (void);
@@ -19,14 +26,30 @@ void _cli(void);
 
 void _sti(void);
 
+/*
+ * Disables interrupts, returning the previous RFLAGS for _irqRestore, so
+ * critical sections nest whether or not interrupts were already off.
+ */
+uint64_t _irqSave(void);
+
+void _irqRestore(uint64_t flags);
+
 void _hlt(void);
 
+void _yield(void);
+
 void picMasterMask(uint8_t mask);
 
 void picSlaveMask(uint8_t mask);
 
+#define TIMER_IRQ 0
+#define KEYBOARD_IRQ 1
+
 #define TIMER_PIC_MASTER 0xFE
 #define KEYBOARD_PIC_MASTER 0xFD
 #define NO_INTERRUPTS 0xFF
 
+// Counters kept by irqDispatcher
+void getInterruptStats(InterruptStats * stats);
+
 #endif
@@ -0,0 +1,32 @@
+#ifndef KERNEL_LOCK_H
+#define KERNEL_LOCK_H
+
+#include <stdint.h>
+
+/*
+ * Big kernel lock. The kernel was written for one CPU, where running with
+ * interrupts disabled was all the mutual exclusion it needed; with several
+ * CPUs every entry into the kernel (syscalls, interrupts, exceptions) takes
+ * this lock instead, so kernel code still runs on one CPU at a time while
+ * processes run in parallel.
+ *
+ * Switching processes does not need it: the run queues have their own locks
+ * (scheduler.c). It nests per CPU. A process switched out inside the kernel
+ * keeps its depth in its PCB, and schedule sets the CPU to the depth of the
+ * one it switches in, taking or dropping the lock as needed.
+ */
+void kernelLock(void);
+void kernelUnlock(void);
+
+/*
+ * Makes this CPU hold the lock `depth` levels deep. For schedule only.
+ */
+void kernelLockSwitch(uint32_t depth);
+
+/*
+ * Drops every level this CPU holds. For the exception path, which abandons
+ * the stack it entered on.
+ */
+void kernelUnlockAll(void);
+
+#endif
@@ -8,11 +8,26 @@
 
 void * memset(void * destination, int32_t character, uint64_t length);
 void * memcpy(void * destination, const void * source, uint64_t length);
+int32_t strcmp(const char * s1, const char * s2);
 void printf(const char * string);
 
 uint8_t getKeyboardBuffer(void);
 uint8_t getKeyboardStatus(void);
 
+uint64_t _rdtsc(void);
+uint64_t _readMSR(uint32_t msr);
+void _writeMSR(uint32_t msr, uint64_t value);
+uint8_t _inb(uint16_t port);
+void _outb(uint16_t port, uint8_t value);
+
+#define CPUID_ERMS (1 << 9)
+uint32_t _cpuidExtendedFeatures(void);
+
+// String instructions, forwards: `count` 8 byte stores or copies, or `length` byte copies
+void _repStosq(void * destination, uint64_t pattern, uint64_t count);
+void _repMovsb(void * destination, const void * source, uint64_t length);
+void _repMovsq(void * destination, const void * source, uint64_t count);
+
 uint8_t getSecond(void);
 uint8_t getMinute(void);
 uint8_t getHour(void);
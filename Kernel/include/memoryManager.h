@@ -5,7 +5,7 @@
 #include "defs.h"
 
 #define ALIGNMENT      8u
-#define ALIGN(sz)      (((sz) + (ALIGNMENT-1)) & ~(ALIGNMENT-1))
+#define ALIGN(sz)      (((sz) + (ALIGNMENT-1)) & ~(uint64_t)(ALIGNMENT-1))
 //lo que hace es (EJEMPLO DEMOSTRATIVO):
 /*
 ALIGN(1)  = 8   // 1 → 8 bytes
@@ -16,13 +16,30 @@ ALIGN(13) = 16  // 13 → 16 bytes
 ALIGN(16) = 16  // 16 → 16 bytes (ya alineado)
 */
 
+/*
+ * Every manager serializes the calls below (except createMemoryManager, which
+ * runs once at boot) with its own reader-writer lock, named "heap" in
+ * get_lock_stats: getMemoryStatus reads, everything else writes. They may be
+ * called with interrupts enabled or disabled.
+ */
+
 /*
  * Initializes the memory manager with a given memory region.
  * Parameters:
  *   memoryStartAddress - The starting address of the memory region.
  *   memorySize - The size of the memory region in bytes.
  */
-void createMemoryManager(void *memoryStartAddress, uint32_t memorySize);
+void createMemoryManager(void *memoryStartAddress, uint64_t memorySize);
+
+/*
+ * Hands an additional memory region to the memory manager, so RAM that is not
+ * contiguous with the first region can be used as well.
+ * Must be called after createMemoryManager, with a region that does not overlap any other.
+ * Parameters:
+ *   memoryStartAddress - The starting address of the memory region.
+ *   memorySize - The size of the memory region in bytes.
+ */
+void addMemoryRegion(void *memoryStartAddress, uint64_t memorySize);
 
 /*
  * Allocates a block of memory of the specified size.
@@ -30,7 +47,17 @@ void createMemoryManager(void *memoryStartAddress, uint32_t memorySize);
  *   size - The size of the memory block to allocate in bytes.
  * Returns a pointer to the allocated memory block, or NULL if allocation fails.
  */
-void *allocMemory(uint32_t size);
+void *allocMemory(uint64_t size);
+
+/*
+ * Resizes a previously allocated memory block, growing it in place when the
+ * neighbouring memory is free and moving it (copying its contents) otherwise.
+ * Parameters:
+ *   memorySegment - Pointer to the memory block to resize, or NULL to allocate.
+ *   size - The new size of the memory block in bytes.
+ * Returns the (possibly moved) block, or NULL if it could not be resized, in which case the original block is left untouched.
+ */
+void *reallocMemory(void *memorySegment, uint64_t size);
 
 /*
  * Frees a previously allocated memory block.
@@ -0,0 +1,31 @@
+#ifndef MEMORY_MAP_H
+#define MEMORY_MAP_H
+
+#include <stdint.h>
+
+#define MAX_MEMORY_REGIONS 32
+
+// E820 region types, as stored by Pure64
+#define E820_USABLE            1
+#define E820_RESERVED          2
+#define E820_ACPI_RECLAIMABLE  3
+
+typedef struct {
+    void    *start;
+    uint64_t size;
+} MemoryRegion;
+
+/*
+ * Reads the E820 memory map Pure64 leaves at 0x4000 and returns the usable
+ * RAM regions that lie at or above `floor` and below the end of the identity
+ * mapping Pure64 sets up, clipped to both and sorted by address.
+ * Falls back to the RAM amount in the Pure64 InfoMap when there is no E820 map.
+ * Parameters:
+ *   regions - Output array.
+ *   maxRegions - Capacity of `regions`.
+ *   floor - Lowest address that may be handed out (end of kernel and modules).
+ * Returns the number of regions written.
+ */
+uint32_t getUsableMemoryRegions(MemoryRegion *regions, uint32_t maxRegions, void *floor);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef PIPE_H
+#define PIPE_H
+
+#include <stdint.h>
+#include <device.h>
+
+#define PIPE_SIZE 4096
+
+typedef struct Pipe Pipe;
+
+// Devices for file descriptors on either end; their context is the Pipe
+extern const Device pipeReadDevice;
+extern const Device pipeWriteDevice;
+
+/*
+ * Creates the pipe cache. Must run after the memory manager is up.
+ */
+void initPipes(void);
+
+/*
+ * Creates a pipe with one reader and one writer reference.
+ * Returns the pipe, or NULL if there is no memory for it.
+ */
+Pipe *pipeCreate(void);
+
+/*
+ * Adds / drops a reference to one end of `pipe`. Dropping the last writer
+ * wakes the readers (they get end of file) and dropping the last reader wakes
+ * the writers (they get an error). The pipe is freed with its last reference.
+ */
+void pipeOpenEnd(Pipe *pipe, uint8_t writeEnd);
+void pipeCloseEnd(Pipe *pipe, uint8_t writeEnd);
+
+/*
+ * Reads up to `count` bytes, blocking while the pipe is empty and has writers.
+ * Returns the bytes read, 0 at end of file.
+ */
+int64_t pipeRead(Pipe *pipe, uint8_t *buffer, uint64_t count);
+
+/*
+ * Writes `count` bytes, blocking while the pipe is full.
+ * Returns the bytes written, or -1 if there are no readers left.
+ */
+int64_t pipeWrite(Pipe *pipe, const uint8_t *buffer, uint64_t count);
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include <stdint.h>
+#include <processInfo.h>
+#include <fileDescriptor.h>
+
+#define PROCESS_STACK_SIZE 0x4000  // per-process stack, also used by its syscalls and interrupts
+#define INIT_PID 1                 // the shell: first process created by the kernel, after idle (pid 0)
+#define IDLE_PID 0                 // shared by the idle process of every CPU
+
+typedef struct Process {
+    pid_t           pid;
+    pid_t           ppid;
+    char            name[PROCESS_NAME_LENGTH];
+    ProcessState    state;
+    int64_t         exitCode;
+    pid_t           waitingFor;     // child pid this process is blocked on in waitpid, 0 if none
+    struct WaitQueue *blockedOn;    // wait queue holding this process, NULL if none
+    uint64_t        wakeTick;       // tick a sleeping process is due at
+    int32_t         sleepIndex;     // slot in the sleep queue, -1 if not sleeping
+
+    uint8_t         priority;       // as set by nice
+    uint8_t         level;          // ready queue it sits in, raised above priority by aging
+    uint64_t        readySince;     // tick it was queued at
+
+    uint64_t        rsp;            // saved stack pointer while switched out
+    uint32_t        lockDepth;      // kernel lock depth it was switched out with
+    int8_t          runningOn;      // index of the CPU running it, -1 once that one is off its stack
+    int8_t          homeCpu;        // CPU whose run queue it waits in: the last one it ran on, -1 before that
+    uint8_t         *stack;
+    char            **argv;         // private copy, freed with the process
+    FileDescriptor  fds[MAX_FDS];   // copied from the parent on creation
+
+    struct Process  *next;          // ready queue or wait queue links
+    struct Process  *prev;
+
+    uint64_t        ticks;
+    uint64_t        dispatches;
+} Process;
+
+/*
+ * Creates the PCB cache and the idle process of the boot CPU. Must run after
+ * the memory manager is up.
+ */
+void initProcesses(void);
+
+/*
+ * Creates an idle process for another CPU, not queued anywhere.
+ * Returns NULL if there is no room or memory for it.
+ */
+Process *createIdleProcess(void);
+
+/*
+ * Creates a process that starts running `entry(argc, argv)` and marks it ready.
+ * The arguments are copied, so the caller's buffers may be reused right away.
+ * Parameters:
+ *   name - Name shown by get_processes (truncated to PROCESS_NAME_LENGTH - 1).
+ *   ppid - Parent pid, 0 for processes started by the kernel.
+ * Returns the new pid, or -1 if there is no room or memory for it.
+ */
+pid_t createProcess(const char *name, ProcessEntry entry, uint64_t argc, char *argv[], pid_t ppid);
+
+/*
+ * Ends the running process with `exitCode`. Never returns.
+ */
+void exitProcess(int64_t exitCode);
+
+/*
+ * Ends the process `pid` as if it had exited with -1.
+ * Returns 0, or -1 if there is no such process (idle and the shell cannot be killed).
+ */
+int32_t killProcess(pid_t pid);
+
+/*
+ * Blocks until the child `pid` (or any child, if pid is -1) exits, then collects it.
+ * Parameters:
+ *   status - Where to store the child's exit code, may be NULL.
+ * Returns the collected pid, or -1 if there is no such child.
+ */
+pid_t waitProcess(pid_t pid, int64_t *status);
+
+/*
+ * Moves a process out of / back into the ready queue.
+ * Returns 0, or -1 if there is no such process or it is not in a state that allows it
+ * (a process in a wait queue or the sleep queue can only be woken by whatever it waits for).
+ */
+int32_t blockProcess(pid_t pid);
+int32_t unblockProcess(pid_t pid);
+
+/*
+ * Changes the priority of `pid`, between PRIORITY_LOWEST and PRIORITY_HIGHEST.
+ * Returns 0, or -1 if there is no such process or the priority is out of range.
+ */
+int32_t niceProcess(pid_t pid, uint8_t priority);
+
+pid_t getCurrentPid(void);
+
+/*
+ * Fills `info` with up to `maxEntries` live processes and returns how many were filled.
+ */
+uint32_t getProcesses(ProcessInfo *info, uint32_t maxEntries);
+
+/*
+ * Called by the exception handlers: kills the faulting process unless it is
+ * the shell, which is restarted instead.
+ */
+void exitFaultingProcess(void);
+
+/*
+ * Frees the exited processes nobody is going to wait for, and wakes the
+ * parents waiting for the others. Processes still on a CPU are skipped: the
+ * scheduler calls it again once that CPU is off their stack, which is when a
+ * process killed while running elsewhere becomes collectable.
+ */
+void releaseDeadProcesses(void);
+
+Process *getIdleProcess(void);    // of the calling CPU
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef ROBUST_LOCK_H
+#define ROBUST_LOCK_H
+
+#include <stdint.h>
+#include <process.h>
+
+#define MAX_ROBUST_LOCKS 16
+
+/*
+ * Userland locks that do not outlive their holder. A robust lock is a pid_t
+ * word, 0 while free and the pid of its holder otherwise. Userland registers
+ * each word once (they are module statics, shared by every process started
+ * from the module); when a process terminates, every registered word it still
+ * holds is reset to 0, so killing it inside a critical section cannot leave
+ * the others spinning forever.
+ */
+
+/*
+ * Registers `lock`. Registering the same word again does nothing.
+ * Returns 0, or -1 if `lock` is NULL or there is no room left.
+ */
+int32_t registerRobustLock(volatile pid_t *lock);
+
+/*
+ * Frees every registered lock held by `pid`. Called when it terminates.
+ */
+void releaseRobustLocks(pid_t pid);
+
+#endif
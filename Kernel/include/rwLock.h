@@ -0,0 +1,88 @@
+#ifndef RW_LOCK_H
+#define RW_LOCK_H
+
+#include <stdint.h>
+#include <spinlock.h>
+
+/*
+ * Reader-writer spinlock, for data that is walked much more often than it
+ * changes. A waiting writer keeps new readers out, so a steady stream of
+ * them cannot starve it. Same rules as Spinlock: no blocking while holding
+ * it, and IrqSave variants for code shared with a handler. Only writers'
+ * hold times are measured.
+ */
+typedef struct {
+    volatile int32_t    readers;        // -1 while a writer holds it
+    volatile uint8_t    writerWaiting;
+    LockStats           stats;
+} RwLock;
+
+#define RWLOCK_INIT             { 0, 0, { NULL, LOCK_RW } }
+#define NAMED_RWLOCK_INIT(name) { 0, 0, { name, LOCK_RW } }
+
+static inline void readLock(RwLock *lock) {
+    uint64_t spins = 0;
+    while (1) {
+        int32_t readers = lock->readers;
+        if (readers >= 0 && !lock->writerWaiting &&
+            __atomic_compare_exchange_n(&lock->readers, &readers, readers + 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            break;
+        __builtin_ia32_pause();
+        spins++;
+    }
+
+    // Readers share the lock, so their counters have to be atomic
+    if (lock->stats.name && !lock->stats.registered)
+        lockStatsRegister(&lock->stats);
+    __atomic_fetch_add(&lock->stats.acquisitions, 1, __ATOMIC_RELAXED);
+    if (spins) {
+        __atomic_fetch_add(&lock->stats.contended, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&lock->stats.contentionSpins, spins, __ATOMIC_RELAXED);
+    }
+}
+
+static inline void readUnlock(RwLock *lock) {
+    __atomic_fetch_sub(&lock->readers, 1, __ATOMIC_RELEASE);
+}
+
+static inline void writeLock(RwLock *lock) {
+    uint64_t spins = 0;
+    int32_t free = 0;
+    while (!__atomic_compare_exchange_n(&lock->readers, &free, -1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        lock->writerWaiting = 1;
+        __builtin_ia32_pause();
+        spins++;
+        free = 0;
+    }
+    lock->writerWaiting = 0;    // another writer still waiting sets it again on its next try
+    lockStatsAcquired(&lock->stats, spins);
+}
+
+static inline void writeUnlock(RwLock *lock) {
+    lockStatsReleased(&lock->stats);
+    __atomic_store_n(&lock->readers, 0, __ATOMIC_RELEASE);
+}
+
+static inline uint64_t readLockIrqSave(RwLock *lock) {
+    uint64_t flags = _irqSave();
+    readLock(lock);
+    return flags;
+}
+
+static inline void readUnlockIrqRestore(RwLock *lock, uint64_t flags) {
+    readUnlock(lock);
+    _irqRestore(flags);
+}
+
+static inline uint64_t writeLockIrqSave(RwLock *lock) {
+    uint64_t flags = _irqSave();
+    writeLock(lock);
+    return flags;
+}
+
+static inline void writeUnlockIrqRestore(RwLock *lock, uint64_t flags) {
+    writeUnlock(lock);
+    _irqRestore(flags);
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <process.h>
+#include <time.h>
+#include <spinlock.h>
+
+#define SCHEDULER_QUANTUM ((TIMER_FREQUENCY + 99) / 100)  // timer ticks per quantum (10ms)
+#define AGING_TICKS       (8 * SCHEDULER_QUANTUM)         // a ready process waiting this long moves up one level
+
+/*
+ * Ready processes of one CPU: one FIFO per priority level, plus the load
+ * counters reported by get_cpu_stats. The lock guards all of it, and the
+ * state of the processes that belong to it (see scheduler.c).
+ */
+typedef struct RunQueue {
+    Spinlock    lock;
+    Process     *head[PRIORITY_LEVELS];
+    Process     *tail[PRIORITY_LEVELS];
+    uint32_t    levels;     // bit (PRIORITY_HIGHEST - level) set <=> that level is not empty
+    uint32_t    length;
+    uint32_t    maxLength;
+    uint64_t    enqueued;   // times a process was made ready here
+    uint64_t    steals;     // processes this CPU took from other queues
+    uint64_t    stolen;     // processes other CPUs took from this queue
+} RunQueue;
+
+/*
+ * Switches this CPU to the first ready process, or to its idle one. Every
+ * CPU calls it once. Never returns; the caller's stack is abandoned.
+ */
+void startScheduler(void);
+
+/*
+ * Called from the timer and reschedule interrupt handlers with the interrupted
+ * stack pointer, once the tick count has been advanced. Returns the stack
+ * pointer to resume: the same one, or the next process once the quantum is
+ * used up (or the running one was blocked or killed from another CPU).
+ */
+uint64_t schedulerTick(uint64_t rsp);
+
+/*
+ * Tick at which the scheduler wants to preempt the process running on this
+ * CPU: the end of its quantum if anyone else is ready, UINT64_MAX otherwise.
+ */
+uint64_t schedulerNextDeadline(void);
+
+/*
+ * Saves the running process at `rsp` and picks the next one, returning its stack pointer.
+ * The running process is queued again only if it is still RUNNING.
+ */
+uint64_t schedule(uint64_t rsp);
+
+/*
+ * Called by the interrupt handlers once they are on the stack schedule
+ * returned: the process switched out is off this CPU, so it can be queued
+ * again, or released if it is dead.
+ */
+void finishSwitch(void);
+
+/*
+ * Gives up the CPU. Used by blocking kernel paths after changing the process state.
+ */
+void yield(void);
+
+/*
+ * Queues a process at its own priority on the CPU it last ran on, or on an
+ * idle one if that one is busy.
+ */
+void readyProcess(Process *process);
+
+/*
+ * Moves a process to `state` (blocked or zombie), taking it out of its run
+ * queue if it is ready. Returns the CPU still running it, which has to be
+ * sent through the scheduler, or -1.
+ */
+int8_t stopProcess(Process *process, ProcessState state);
+
+/*
+ * Sets the priority of `process`, moving it to its new queue if it is ready.
+ */
+void setPriority(Process *process, uint8_t priority);
+
+Process *getCurrentProcess(void);
+
+/*
+ * Times the scheduler switched from one process to a different one.
+ */
+uint64_t getContextSwitches(void);
+
+#endif
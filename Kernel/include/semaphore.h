@@ -0,0 +1,44 @@
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+#include <stdint.h>
+#include <process.h>
+
+#define MAX_SEMAPHORES      64
+#define SEM_NAME_LENGTH     32
+
+typedef int32_t sem_t;
+typedef struct Semaphore Semaphore;
+
+/*
+ * Creates the semaphore cache. Must run after the memory manager is up.
+ */
+void initSemaphores(void);
+
+/*
+ * Opens the semaphore called `name`, creating it with `initialValue` if it
+ * does not exist. Every open must be paired with a semClose.
+ * Returns its id, or -1 if there is no room or memory for it.
+ */
+sem_t semOpen(const char *name, uint32_t initialValue);
+
+/*
+ * Drops one reference to `id`; the semaphore is destroyed with the last one,
+ * or once nobody waits on it any more.
+ * Returns 0, or -1 if `id` is not open or has no references left.
+ */
+int32_t semClose(sem_t id);
+
+/*
+ * Decrements `id`, blocking the running process in FIFO order while it is 0.
+ * Returns 0, or -1 if `id` is not open.
+ */
+int32_t semWait(sem_t id);
+
+/*
+ * Wakes the oldest waiter of `id`, or increments it if nobody is waiting.
+ * Returns 0, or -1 if `id` is not open.
+ */
+int32_t semPost(sem_t id);
+
+#endif
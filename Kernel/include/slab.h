@@ -0,0 +1,48 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <stdint.h>
+#include "defs.h"
+
+/*
+ * Object caches for fixed-size kernel objects (PCBs, semaphores, queue nodes...).
+ * Slabs are carved from the general memory manager; allocating from a cache
+ * is a pop from a per-slab free list and freeing is a push.
+ */
+
+typedef struct KmemCache KmemCache;
+
+// Runs once per object when its slab is created. Objects must be handed back
+// to kmem_cache_free in their constructed state.
+typedef void (*KmemConstructor)(void *object);
+
+/*
+ * Creates a cache of objects of `objectSize` bytes.
+ * Parameters:
+ *   name - Name shown in the cache statistics (truncated to SLAB_NAME_LENGTH - 1).
+ *   objectSize - Size of every object, at most SLAB_MAX_OBJECT_SIZE bytes.
+ *   constructor - Optional constructor, may be NULL.
+ * Returns the cache, or NULL if there are too many caches or the object is too large.
+ */
+KmemCache *kmem_cache_create(const char *name, uint32_t objectSize, KmemConstructor constructor);
+
+/*
+ * Allocates one object from `cache`.
+ * Returns the object, or NULL if the memory manager is out of memory.
+ */
+void *kmem_cache_alloc(KmemCache *cache);
+
+/*
+ * Returns `object` to the cache it was allocated from.
+ */
+void kmem_cache_free(KmemCache *cache, void *object);
+
+/*
+ * Fills the slab section of `status` with per-cache statistics.
+ */
+void getSlabStatus(MemoryStatus *status);
+
+#define SLAB_SIZE            4096
+#define SLAB_MAX_OBJECT_SIZE (SLAB_SIZE / 4)
+
+#endif
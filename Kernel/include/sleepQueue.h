@@ -0,0 +1,35 @@
+#ifndef SLEEP_QUEUE_H
+#define SLEEP_QUEUE_H
+
+#include <stdint.h>
+#include <process.h>
+
+/*
+ * Processes sleeping until a given tick, in a min-heap ordered by that tick.
+ * The timer interrupt wakes exactly the ones whose deadline has passed, so a
+ * sleeper costs nothing until then. Like the wait queues, this relies on
+ * interrupts being disabled around every call.
+ */
+
+/*
+ * Blocks `process` until tick `wakeTick`. The caller must yield() afterwards
+ * if `process` is the running one.
+ */
+void sleepQueueAdd(Process *process, uint64_t wakeTick);
+
+/*
+ * Readies every process whose wake tick is `now` or earlier. Called on each timer tick.
+ */
+void sleepQueueWake(uint64_t now);
+
+/*
+ * Tick the earliest sleeper is due at, UINT64_MAX if nobody is sleeping.
+ */
+uint64_t sleepQueueNextWake(void);
+
+/*
+ * Takes `process` out of the queue without readying it, if it is sleeping. Used when it is killed.
+ */
+void sleepQueueCancel(Process *process);
+
+#endif
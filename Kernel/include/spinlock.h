@@ -0,0 +1,96 @@
+#ifndef SPINLOCK_H
+#define SPINLOCK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <lockInfo.h>
+#include <interrupts.h>
+#include <lib.h>
+
+/*
+ * Counters kept by every lock. The ones of exclusive holds are updated while
+ * holding the lock, so they need no atomics. Named locks show up in
+ * get_lock_stats from their first acquisition on.
+ */
+typedef struct LockStats {
+    const char      *name;          // NULL keeps it out of get_lock_stats
+    uint8_t         kind;           // LockKind
+    volatile uint8_t registered;
+    uint64_t        acquisitions;
+    uint64_t        contended;
+    uint64_t        contentionSpins;
+    uint64_t        maxHoldCycles;
+    uint64_t        acquiredAt;     // TSC when the current exclusive holder got it
+} LockStats;
+
+/*
+ * Adds `stats` to the locks reported by get_lock_stats. Lock-free, since it
+ * runs inside whatever lock is being registered.
+ */
+void lockStatsRegister(LockStats *stats);
+
+/*
+ * Fills `info` with up to `maxEntries` registered locks and returns how many were filled.
+ */
+uint32_t getLockStats(LockInfo *info, uint32_t maxEntries);
+
+static inline void lockStatsAcquired(LockStats *stats, uint64_t spins) {
+    if (stats->name && !stats->registered)
+        lockStatsRegister(stats);
+    stats->acquisitions++;
+    if (spins) {
+        stats->contended++;
+        stats->contentionSpins += spins;
+    }
+    stats->acquiredAt = _rdtsc();
+}
+
+static inline void lockStatsReleased(LockStats *stats) {
+    uint64_t held = _rdtsc() - stats->acquiredAt;
+    if (held > stats->maxHoldCycles)
+        stats->maxHoldCycles = held;
+}
+
+/*
+ * Ticket spinlock: CPUs get the lock in the order they asked for it, so none
+ * of them starves while others keep taking it. Holders must not block or
+ * yield. Kernel paths already run with interrupts disabled; code that may
+ * run with them enabled and shares the lock with a handler uses the
+ * IrqSave variants, so the handler cannot spin on its own CPU's lock.
+ */
+typedef struct {
+    volatile uint16_t   next;   // ticket for the next CPU to arrive
+    volatile uint16_t   owner;  // ticket being served
+    LockStats           stats;
+} Spinlock;
+
+#define SPINLOCK_INIT               { 0, 0, { NULL, LOCK_SPIN } }
+#define NAMED_SPINLOCK_INIT(name)   { 0, 0, { name, LOCK_SPIN } }
+
+static inline void spinLock(Spinlock *lock) {
+    uint16_t ticket = __atomic_fetch_add(&lock->next, 1, __ATOMIC_RELAXED);
+    uint64_t spins = 0;
+    while (__atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE) != ticket) {
+        __builtin_ia32_pause();
+        spins++;
+    }
+    lockStatsAcquired(&lock->stats, spins);
+}
+
+static inline void spinUnlock(Spinlock *lock) {
+    lockStatsReleased(&lock->stats);
+    __atomic_store_n(&lock->owner, (uint16_t) (lock->owner + 1), __ATOMIC_RELEASE);
+}
+
+static inline uint64_t spinLockIrqSave(Spinlock *lock) {
+    uint64_t flags = _irqSave();
+    spinLock(lock);
+    return flags;
+}
+
+static inline void spinUnlockIrqRestore(Spinlock *lock, uint64_t flags) {
+    spinUnlock(lock);
+    _irqRestore(flags);
+}
+
+#endif
@@ -4,6 +4,12 @@
 #include <stdint.h>
 #include <keyboard.h>
 #include <memoryManager.h>
+#include <syscallTable.h>
+#include <processInfo.h>
+#include <clock.h>
+#include <interruptStats.h>
+#include <cpuInfo.h>
+#include <lockInfo.h>
 
 typedef struct
 {
@@ -25,53 +31,103 @@ typedef struct
 	int64_t rip;
 } Registers;
 
-int32_t syscallDispatcher(Registers *registers);
+int64_t syscallDispatcher(Registers *registers);
+int64_t syscallDispatch(uint64_t arg0, uint64_t arg1, uint64_t arg2, uint64_t arg3, uint64_t arg4, uint64_t number);
+
+/*
+ * Every handler takes its arguments as the raw 64 bit registers they arrive
+ * in and returns a full int64_t, converting to the real types itself, so
+ * the dispatcher calls each one through its own prototype (see the thunks
+ * in syscallDispatcher.c).
+ */
 
 // Linux syscall prototypes
-int32_t sys_write(int32_t fd, char *__user_buf, int32_t count);
-int32_t sys_read(int32_t fd, signed char *__user_buf, int32_t count);
+int64_t sys_write(uint64_t fd, uint64_t __user_buf, uint64_t count);
+int64_t sys_read(uint64_t fd, uint64_t __user_buf, uint64_t count);
 
 // Custom syscall prototypes
-int32_t sys_start_beep(uint32_t nFrequence);
-int32_t sys_stop_beep(void);
-int32_t sys_fonts_text_color(uint32_t color);
-int32_t sys_fonts_background_color(uint32_t color);
-int32_t sys_fonts_decrease_size(void);
-int32_t sys_fonts_increase_size(void);
-int32_t sys_fonts_set_size(uint8_t size);
-int32_t sys_clear_screen(void);
-int32_t sys_clear_input_buffer(void);
-uint16_t sys_window_width(void);
-uint16_t sys_window_height(void);
+int64_t sys_start_beep(uint64_t nFrequence);
+int64_t sys_stop_beep(void);
+int64_t sys_fonts_text_color(uint64_t color);
+int64_t sys_fonts_background_color(uint64_t color);
+int64_t sys_fonts_decrease_size(void);
+int64_t sys_fonts_increase_size(void);
+int64_t sys_fonts_set_size(uint64_t size);
+int64_t sys_clear_screen(void);
+int64_t sys_clear_input_buffer(void);
+int64_t sys_window_width(void);
+int64_t sys_window_height(void);
 
 // Date syscall prototypes
-int32_t sys_hour(int *hour);
-int32_t sys_minute(int *minute);
-int32_t sys_second(int *second);
+int64_t sys_hour(uint64_t hour);
+int64_t sys_minute(uint64_t minute);
+int64_t sys_second(uint64_t second);
 
-int32_t sys_circle(uint32_t hexColor, uint64_t topLeftX, uint64_t topLeftY, uint64_t diameter);
+int64_t sys_circle(uint64_t hexColor, uint64_t topLeftX, uint64_t topLeftY, uint64_t diameter);
 // Draw rectangle syscall prototype
-int32_t sys_rectangle(uint32_t color, uint64_t width_pixels, uint64_t height_pixels, uint64_t initial_pos_x, uint64_t initial_pos_y);
-int32_t sys_fill_video_memory(uint32_t hexColor);
+int64_t sys_rectangle(uint64_t color, uint64_t width_pixels, uint64_t height_pixels, uint64_t initial_pos_x, uint64_t initial_pos_y);
+int64_t sys_fill_video_memory(uint64_t hexColor);
 
 // Custom exec syscall prototype
-int32_t sys_exec(int32_t (*fnPtr)(void));
+int64_t sys_exec(uint64_t fnPtr);
 
 // Custom keyboard syscall prototypes
-int32_t sys_register_key(uint8_t scancode, SpecialKeyHandler fn);
+int64_t sys_register_key(uint64_t scancode, uint64_t fn);
 
 // System sleep
-int32_t sys_sleep_milis(uint32_t milis);
+int64_t sys_sleep_milis(uint64_t milis);
 
 // Register snapshot
-int32_t sys_get_register_snapshot(int64_t *registers);
+int64_t sys_get_register_snapshot(uint64_t snapshot);
 
 // Get character without showing
-int32_t sys_get_character_without_display(void);
+int64_t sys_get_character_without_display(void);
+
+// Syscall table introspection
+int64_t sys_abi_version(void);
+int64_t sys_null(void);
+int64_t sys_get_syscall_stats(uint64_t statsArg, uint64_t maxEntries);
 
 // Memory management syscall prototypes
-int32_t sys_get_mem_status(MemoryStatus *memStatus);
-void *sys_malloc(int size);
-int32_t sys_free(void *ptr);
+int64_t sys_get_mem_status(uint64_t memStatus);
+int64_t sys_malloc(uint64_t size);
+int64_t sys_free(uint64_t ptr);
+int64_t sys_realloc(uint64_t ptr, uint64_t size);
+int64_t sys_calloc(uint64_t count, uint64_t size);
+
+// Process syscall prototypes
+int64_t sys_create_process(uint64_t name, uint64_t entry, uint64_t argc, uint64_t argv);
+int64_t sys_getpid(void);
+int64_t sys_yield(void);
+int64_t sys_kill(uint64_t pid);
+int64_t sys_waitpid(uint64_t pid, uint64_t status);
+int64_t sys_block(uint64_t pid);
+int64_t sys_unblock(uint64_t pid);
+int64_t sys_get_processes(uint64_t info, uint64_t maxEntries);
+int64_t sys_exit(uint64_t code);
+int64_t sys_nice(uint64_t pid, uint64_t priority);
+
+// Semaphore syscall prototypes
+int64_t sys_sem_open(uint64_t name, uint64_t initialValue);
+int64_t sys_sem_wait(uint64_t id);
+int64_t sys_sem_post(uint64_t id);
+int64_t sys_sem_close(uint64_t id);
+int64_t sys_context_switches(void);
+
+// File descriptor syscall prototypes
+int64_t sys_pipe(uint64_t fds);
+int64_t sys_close(uint64_t fd);
+int64_t sys_dup(uint64_t fd);
+int64_t sys_dup2(uint64_t fd, uint64_t target);
+int64_t sys_open(uint64_t name);
+
+// Clock syscall prototypes
+int64_t sys_clock_gettime(uint64_t clockId, uint64_t tsArg);
+int64_t sys_get_interrupt_stats(uint64_t stats);
+int64_t sys_set_irq_affinity(uint64_t irq, uint64_t apicId);
+int64_t sys_get_cpu_stats(uint64_t info, uint64_t maxEntries);
+int64_t sys_get_lock_stats(uint64_t info, uint64_t maxEntries);
+int64_t sys_flush_video(void);
+int64_t sys_register_robust_lock(uint64_t lock);
 
 #endif
\ No newline at end of file
@@ -2,13 +2,75 @@
 #define _TIME_H_
 
 #include <stdint.h>
+#include <clock.h>
 
-#define SECONDS_TO_TICKS 18
+// Timer interrupt rate. The PIT divisor is 16 bits, so anything from 19 Hz up works
+#ifndef TIMER_FREQUENCY
+#define TIMER_FREQUENCY 1000
+#endif
+
+#define SECONDS_TO_TICKS TIMER_FREQUENCY
+
+/*
+ * Programs PIT channel 0 to TIMER_FREQUENCY and calibrates the TSC and the
+ * local APIC timer against channel 2. If both work the kernel runs tickless:
+ * the PIT stays masked and the APIC timer is programmed one-shot for the next
+ * deadline. Must run before load_idt.
+ */
+void initTimer(void);
+
+/*
+ * 1 if the local APIC one-shot timer drives the ticks, 0 if the PIT does.
+ */
+uint8_t isTickless(void);
+
+/*
+ * 1 if the local APIC timer could be calibrated, which the other CPUs need
+ * for their quanta.
+ */
+uint8_t hasLocalTimer(void);
+
+/*
+ * Sets up the local APIC timer of a CPU other than the boot one, stopped.
+ */
+void initCpuTimer(void);
+
+/*
+ * Reprograms this CPU's one-shot after something may have moved its
+ * earliest deadline closer (a process readied, a sleeper queued...).
+ * Does nothing on the boot CPU with the PIT.
+ */
+void timerDeadlinesChanged(void);
+
+/*
+ * Same for a deadline only the boot CPU watches (the sleep queue, the
+ * cursor, the video flush): from another CPU it sends the boot one a
+ * reschedule IPI, on the way out of which it re-arms.
+ */
+void bootTimerDeadlinesChanged(void);
+
+/*
+ * Called by the local APIC timer and reschedule handlers once the scheduler
+ * has picked who runs next: arms the next one-shot and signals the EOI.
+ */
+void apicInterruptEnd(void);
 
 void timer_handler();
-int ticks_elapsed();
+uint64_t getTicks(void);    // ticks up to now (with the PIT, up to the last timer interrupt)
+int ticks_elapsed();        // ticks up to now
 int seconds_elapsed();
 void sleep(int seconds);
 void sleepTicks(uint64_t sleep_t);
 
+/*
+ * Nanoseconds since initTimer, from the TSC (or from the tick count if it
+ * could not be calibrated).
+ */
+uint64_t monotonicNanoseconds(void);
+
+/*
+ * TSC cycles per second as measured at boot, 0 if calibration failed.
+ */
+uint64_t getTSCFrequency(void);
+
 #endif
@@ -2,15 +2,50 @@
 #define VIDEO_DRIVER_H
 
 #include <stdint.h>
+#include <time.h>
+
+// Picks the fill and copy routines for the video mode and the CPU, once at boot
+void initVideo(void);
 
 void putPixel(uint32_t hexColor, uint64_t x, uint64_t y);
+// `length` pixels from (x, y) to the right, clipped to the screen; rectangles and circles are drawn as spans
+void drawSpan(uint32_t hexColor, uint64_t x, uint64_t y, uint64_t length);
 void drawCircle(uint32_t hexColor, uint64_t topLeftX, uint64_t topLeftY, uint64_t diameter);
 void drawRectangle(uint32_t hexColor, uint64_t width, uint64_t height, uint64_t initial_pos_x, uint64_t initial_pos_y);
 void fillVideoMemory(uint32_t hexColor);
 
+/*
+ * Pixels in the framebuffer's own format, getBytesPerPixel() bytes each:
+ * encodeColor writes one, copyPixelRow copies `count` of them to the row
+ * starting at (x, y) in a single memcpy.
+ */
+uint8_t getBytesPerPixel(void);
+void encodeColor(uint32_t hexColor, uint8_t * pixel);
+void copyPixelRow(const uint8_t * pixels, uint64_t x, uint64_t y, uint64_t count);
+
 uint16_t getWindowWidth(void);
 uint16_t getWindowHeight(void);
 
 void scrollVideoMemoryUp(uint16_t scroll, uint32_t fillColor);
 
+// Longest a change can stay in the back buffer before the timer flushes it (~60 Hz)
+#ifndef VIDEO_FLUSH_TICKS
+#define VIDEO_FLUSH_TICKS (SECONDS_TO_TICKS / 60)
+#endif
+
+/*
+ * Moves drawing to a RAM copy of the framebuffer, from which only the
+ * changed spans of each row are copied out. Needs the heap; until it runs
+ * (or if it fails, or the kernel was built with NO_BACK_BUFFER) everything
+ * is drawn straight to the framebuffer and the rest of these do nothing.
+ */
+void initBackBuffer(void);
+
+// Copies whatever changed since the last flush to the framebuffer
+void flushVideo(void);
+
+// Tick by which the pending changes must be flushed, UINT64_MAX if none are
+uint64_t nextVideoFlush(uint64_t tick);
+void flushVideoIfDue(uint64_t tick);
+
 #endif
\ No newline at end of file
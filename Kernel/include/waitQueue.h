@@ -0,0 +1,42 @@
+#ifndef WAIT_QUEUE_H
+#define WAIT_QUEUE_H
+
+#include <stdint.h>
+#include <process.h>
+
+/*
+ * FIFO of blocked processes, linked through their next/prev fields (a
+ * blocked process is never in a ready queue). Callers serialize access,
+ * either with interrupts disabled or under their own lock.
+ */
+typedef struct WaitQueue {
+    Process *head;
+    Process *tail;
+} WaitQueue;
+
+#define WAIT_QUEUE_INIT { NULL, NULL }
+
+/*
+ * Blocks `process` at the tail of `queue`. The caller must yield() afterwards
+ * (after releasing its own locks) if `process` is the running one.
+ */
+void waitQueueAdd(WaitQueue *queue, Process *process);
+
+/*
+ * Readies the oldest process in `queue`.
+ * Returns it, or NULL if the queue was empty.
+ */
+Process *waitQueueWakeOne(WaitQueue *queue);
+
+/*
+ * Readies every process in `queue`.
+ */
+void waitQueueWakeAll(WaitQueue *queue);
+
+/*
+ * Takes `process` out of the queue it is blocked in, without readying it.
+ * Used when it is killed.
+ */
+void waitQueueCancel(Process *process);
+
+#endif
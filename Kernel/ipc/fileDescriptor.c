@@ -0,0 +1,150 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * Per-process file descriptor tables. An fd points to a device (console,
+ * keyboard, pipe end, null) and the context its methods run on, so reads and
+ * writes are a single indirect call and dup2 is a pointer copy. A process
+ * starts with a copy of its creator's table, which is how the shell hands
+ * pipes to the stages of a pipeline.
+ */
+
+#include <fileDescriptor.h>
+#include <scheduler.h>
+#include <console.h>
+#include <pipe.h>
+#include <lib.h>
+#include <stddef.h>
+
+static FileDescriptor *getFd(int32_t fd) {
+    Process *process = getCurrentProcess();
+    if (!process || fd < 0 || fd >= MAX_FDS || process->fds[fd].device == NULL)
+        return NULL;
+    return &process->fds[fd];
+}
+
+static void reference(const FileDescriptor *entry) {
+    if (entry->device && entry->device->open)
+        entry->device->open(entry->context);
+}
+
+static void release(FileDescriptor *entry) {
+    if (entry->device && entry->device->close)
+        entry->device->close(entry->context);
+    entry->device = NULL;
+    entry->context = NULL;
+}
+
+static int32_t lowestFreeFd(const FileDescriptor *fds, int32_t from) {
+    for (int32_t i = from; i < MAX_FDS; i++)
+        if (fds[i].device == NULL)
+            return i;
+    return -1;
+}
+
+void initFileDescriptors(FileDescriptor *fds, const FileDescriptor *inherited) {
+    if (inherited) {
+        for (int32_t i = 0; i < MAX_FDS; i++) {
+            fds[i] = inherited[i];
+            reference(&fds[i]);
+        }
+        return;
+    }
+
+    for (int32_t i = 0; i < MAX_FDS; i++)
+        fds[i] = (FileDescriptor){ NULL, NULL };
+    fds[FD_STDIN] = (FileDescriptor){ &keyboardDevice, NULL };
+    fds[FD_STDOUT] = (FileDescriptor){ &consoleDevice, getConsoleStream(FD_STDOUT) };
+    fds[FD_STDERR] = (FileDescriptor){ &consoleDevice, getConsoleStream(FD_STDERR) };
+}
+
+void closeFileDescriptors(FileDescriptor *fds) {
+    for (int32_t i = 0; i < MAX_FDS; i++)
+        release(&fds[i]);
+}
+
+int64_t fdRead(int32_t fd, void *buffer, uint64_t count) {
+    FileDescriptor *entry = getFd(fd);
+    if (!entry || !entry->device->read)
+        return -1;
+    return entry->device->read(entry->context, buffer, count);
+}
+
+int64_t fdWrite(int32_t fd, const void *buffer, uint64_t count) {
+    FileDescriptor *entry = getFd(fd);
+    if (!entry || !entry->device->write)
+        return -1;
+    return entry->device->write(entry->context, buffer, count);
+}
+
+int32_t fdClose(int32_t fd) {
+    FileDescriptor *entry = getFd(fd);
+    if (!entry)
+        return -1;
+
+    release(entry);
+    return 0;
+}
+
+int32_t fdDup2(int32_t fd, int32_t target) {
+    FileDescriptor *entry = getFd(fd);
+    if (!entry || target < 0 || target >= MAX_FDS)
+        return -1;
+    if (fd == target)
+        return target;
+
+    FileDescriptor *fds = getCurrentProcess()->fds;
+    reference(entry);       // before releasing, in case both share the last reference
+    release(&fds[target]);
+    fds[target] = *entry;
+    return target;
+}
+
+int32_t fdDup(int32_t fd) {
+    int32_t target = lowestFreeFd(getCurrentProcess()->fds, 0);
+    return target == -1 ? -1 : fdDup2(fd, target);
+}
+
+int32_t fdPipe(int32_t fds[2]) {
+    FileDescriptor *table = getCurrentProcess()->fds;
+    int32_t readFd = lowestFreeFd(table, 0);
+    int32_t writeFd = readFd == -1 ? -1 : lowestFreeFd(table, readFd + 1);
+    if (writeFd == -1)
+        return -1;
+
+    Pipe *pipe = pipeCreate();
+    if (!pipe)
+        return -1;
+
+    table[readFd] = (FileDescriptor){ &pipeReadDevice, pipe };
+    table[writeFd] = (FileDescriptor){ &pipeWriteDevice, pipe };
+    fds[0] = readFd;
+    fds[1] = writeFd;
+    return 0;
+}
+
+int32_t fdOpen(const char *name) {
+    static const struct {
+        const char   *name;
+        const Device *device;
+        int32_t      stream;
+    } named[] = {
+        { "keyboard", &keyboardDevice, FD_STDIN },
+        { "console",  &consoleDevice,  FD_STDOUT },
+        { "error",    &consoleDevice,  FD_STDERR },
+        { "null",     &nullDevice,     FD_STDIN },
+    };
+
+    FileDescriptor *table = getCurrentProcess()->fds;
+    int32_t fd = lowestFreeFd(table, 0);
+    if (fd == -1 || name == NULL)
+        return -1;
+
+    for (uint32_t i = 0; i < sizeof(named) / sizeof(named[0]); i++) {
+        if (strcmp(named[i].name, name) == 0) {
+            table[fd] = (FileDescriptor){ named[i].device, getConsoleStream(named[i].stream) };
+            return fd;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,206 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * Anonymous pipes over a PIPE_SIZE ring buffer.
+ *
+ * A reader that finds the pipe empty leaves a PendingRead (on its own stack)
+ * describing its destination buffer and sleeps in `directQueue`. A writer
+ * that finds such a reader copies straight into its buffer and wakes it, so
+ * data only goes through the ring when nobody is already waiting for it.
+ * Only one reader at a time can be pending; others sleep in `readQueue`
+ * until the pipe has data or the slot frees up.
+ *
+ * A killed pending reader leaves `directQueue` through waitQueueCancel, so a
+ * writer only trusts `pending` while its owner is still in that queue.
+ *
+ * The ring and the queues have no lock of their own: every syscall runs
+ * holding the big kernel lock (kernelLock.h), which serializes them across
+ * CPUs, with interrupts disabled on the CPU running it. Splitting the pipe
+ * syscalls out from under that lock needs a per-pipe lock first.
+ */
+
+#include <pipe.h>
+#include <waitQueue.h>
+#include <scheduler.h>
+#include <memoryManager.h>
+#include <slab.h>
+#include <lib.h>
+#include <stddef.h>
+
+typedef struct {
+    uint8_t  *buffer;
+    uint64_t count;
+    uint64_t filled;
+} PendingRead;
+
+struct Pipe {
+    uint8_t     *buffer;
+    uint32_t    readIndex;
+    uint32_t    count;
+    uint32_t    readers;
+    uint32_t    writers;
+    PendingRead *pending;       // valid while its reader is in directQueue
+    WaitQueue   directQueue;
+    WaitQueue   readQueue;
+    WaitQueue   writeQueue;
+};
+
+static KmemCache *pipeCache = NULL;
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+void initPipes(void) {
+    pipeCache = kmem_cache_create("pipe", sizeof(Pipe), NULL);
+}
+
+Pipe *pipeCreate(void) {
+    Pipe *pipe = kmem_cache_alloc(pipeCache);
+    if (!pipe)
+        return NULL;
+
+    pipe->buffer = allocMemory(PIPE_SIZE);
+    if (!pipe->buffer) {
+        kmem_cache_free(pipeCache, pipe);
+        return NULL;
+    }
+
+    pipe->readIndex = pipe->count = 0;
+    pipe->readers = pipe->writers = 1;
+    pipe->pending = NULL;
+    pipe->directQueue = (WaitQueue)WAIT_QUEUE_INIT;
+    pipe->readQueue = (WaitQueue)WAIT_QUEUE_INIT;
+    pipe->writeQueue = (WaitQueue)WAIT_QUEUE_INIT;
+    return pipe;
+}
+
+void pipeOpenEnd(Pipe *pipe, uint8_t writeEnd) {
+    if (writeEnd) pipe->writers++;
+    else          pipe->readers++;
+}
+
+void pipeCloseEnd(Pipe *pipe, uint8_t writeEnd) {
+    if (writeEnd) {
+        if (--pipe->writers == 0) {
+            waitQueueWakeAll(&pipe->directQueue);
+            waitQueueWakeAll(&pipe->readQueue);
+        }
+    } else if (--pipe->readers == 0) {
+        waitQueueWakeAll(&pipe->writeQueue);
+    }
+
+    if (pipe->readers == 0 && pipe->writers == 0) {
+        freeMemory(pipe->buffer);
+        kmem_cache_free(pipeCache, pipe);
+    }
+}
+
+/* Copies up to `count` bytes out of the ring */
+static uint64_t ringRead(Pipe *pipe, uint8_t *buffer, uint64_t count) {
+    uint64_t n = MIN(count, pipe->count);
+    uint64_t first = MIN(n, PIPE_SIZE - pipe->readIndex);
+    memcpy(buffer, pipe->buffer + pipe->readIndex, first);
+    memcpy(buffer + first, pipe->buffer, n - first);
+    pipe->readIndex = (pipe->readIndex + n) % PIPE_SIZE;
+    pipe->count -= n;
+    return n;
+}
+
+/* Copies up to `count` bytes into the ring's free space */
+static uint64_t ringWrite(Pipe *pipe, const uint8_t *buffer, uint64_t count) {
+    uint64_t n = MIN(count, PIPE_SIZE - pipe->count);
+    uint32_t writeIndex = (pipe->readIndex + pipe->count) % PIPE_SIZE;
+    uint64_t first = MIN(n, PIPE_SIZE - writeIndex);
+    memcpy(pipe->buffer + writeIndex, buffer, first);
+    memcpy(pipe->buffer, buffer + first, n - first);
+    pipe->count += n;
+    return n;
+}
+
+int64_t pipeRead(Pipe *pipe, uint8_t *buffer, uint64_t count) {
+    if (count == 0)
+        return 0;
+
+    while (1) {
+        if (pipe->count) {
+            uint64_t n = ringRead(pipe, buffer, count);
+            waitQueueWakeAll(&pipe->writeQueue);
+            return n;
+        }
+
+        if (pipe->writers == 0)
+            return 0;
+
+        Process *self = getCurrentProcess();
+        if (pipe->pending && pipe->directQueue.head) {
+            // Somebody else is pending already
+            waitQueueAdd(&pipe->readQueue, self);
+            yield();
+            continue;
+        }
+
+        PendingRead request = { buffer, count, 0 };
+        pipe->pending = &request;
+        waitQueueAdd(&pipe->directQueue, self);
+        yield();
+
+        if (pipe->pending == &request)
+            pipe->pending = NULL;
+        waitQueueWakeOne(&pipe->readQueue);
+
+        if (request.filled)
+            return request.filled;
+        // Woken by the last writer closing, or by data landing in the ring
+    }
+}
+
+int64_t pipeWrite(Pipe *pipe, const uint8_t *buffer, uint64_t count) {
+    uint64_t written = 0;
+
+    while (written < count) {
+        if (pipe->readers == 0)
+            return written ? (int64_t)written : -1;
+
+        // Straight into the buffer of a reader that is already waiting
+        if (pipe->pending && pipe->directQueue.head) {
+            PendingRead *request = pipe->pending;
+            uint64_t n = MIN(count - written, request->count);
+            memcpy(request->buffer, buffer + written, n);
+            request->filled = n;
+            pipe->pending = NULL;
+            waitQueueWakeOne(&pipe->directQueue);
+            written += n;
+            continue;
+        }
+        pipe->pending = NULL; // its reader was killed or is already awake
+
+        if (pipe->count < PIPE_SIZE) {
+            written += ringWrite(pipe, buffer + written, count - written);
+            waitQueueWakeAll(&pipe->directQueue);
+            waitQueueWakeAll(&pipe->readQueue);
+            continue;
+        }
+
+        waitQueueAdd(&pipe->writeQueue, getCurrentProcess());
+        yield();
+    }
+
+    return written;
+}
+
+/* Device methods for the two ends, the context is the Pipe itself */
+static int64_t readEndRead(void *pipe, uint8_t *buffer, uint64_t count) {
+    return pipeRead(pipe, buffer, count);
+}
+
+static int64_t writeEndWrite(void *pipe, const uint8_t *buffer, uint64_t count) {
+    return pipeWrite(pipe, buffer, count);
+}
+
+static void readEndOpen(void *pipe)   { pipeOpenEnd(pipe, 0); }
+static void readEndClose(void *pipe)  { pipeCloseEnd(pipe, 0); }
+static void writeEndOpen(void *pipe)  { pipeOpenEnd(pipe, 1); }
+static void writeEndClose(void *pipe) { pipeCloseEnd(pipe, 1); }
+
+const Device pipeReadDevice = { "pipe", readEndRead, NULL, readEndOpen, readEndClose };
+const Device pipeWriteDevice = { "pipe", NULL, writeEndWrite, writeEndOpen, writeEndClose };
@@ -8,6 +8,13 @@
 #include <syscallDispatcher.h>
 #include <sound.h>
 #include <memoryManager.h>
+#include <memoryMap.h>
+#include <process.h>
+#include <scheduler.h>
+#include <semaphore.h>
+#include <pipe.h>
+#include <time.h>
+#include <cpu.h>
 
 // extern uint8_t text;
 // extern uint8_t rodata;
@@ -22,9 +29,8 @@ static const uint64_t PageSize = 0x1000;
 static void * const shellModuleAddress = (void *)0x400000;
 static void * const snakeModuleAddress = (void *)0x500000;
 
-//HEAP
-static void *const memoryStart = (void *)0xF00000;
-const int memorySize = (1 << 20); // 1GB
+//HEAP: all usable RAM above the kernel and the module slots (each module gets 1 MiB)
+static void * const heapFloor = (void *)0x600000;
 
 typedef int (*EntryPoint)();
 
@@ -54,14 +60,39 @@ void * initializeKernelBinary(){
 	return getStackBase();
 }
 
+void initializeMemory() {
+	MemoryRegion regions[MAX_MEMORY_REGIONS];
+	uint32_t count = getUsableMemoryRegions(regions, MAX_MEMORY_REGIONS, heapFloor);
+	uint8_t created = 0;
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (!created) {
+			createMemoryManager(regions[i].start, regions[i].size);
+			created = 1;
+		} else {
+			addMemoryRegion(regions[i].start, regions[i].size);
+		}
+	}
+}
+
 int main(){	
+	initBootCpu();
+	initVideo();
+	initTimer();
 	load_idt();
 
-	createMemoryManager(memoryStart, memorySize);
+	initializeMemory();
+	initBackBuffer();
 
 	setFontSize(2);
-	
-	((EntryPoint)shellModuleAddress)();
+
+	initProcesses();
+	initSemaphores();
+	initPipes();
+	createProcess("shell", (ProcessEntry)shellModuleAddress, 0, NULL, 0);
+
+	startApplicationProcessors();
+	startScheduler();
 
 	__builtin_unreachable();
 
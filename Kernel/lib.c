@@ -49,3 +49,12 @@ void * memcpy(void * destination, const void * source, uint64_t length)
 
 	return destination;
 }
+
+int32_t strcmp(const char * s1, const char * s2)
+{
+	while (*s1 && *s1 == *s2) {
+		s1++;
+		s2++;
+	}
+	return (uint8_t)*s1 - (uint8_t)*s2;
+}
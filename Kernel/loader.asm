@@ -1,11 +1,24 @@
 global loader
+global apLoader
 extern main
 extern initializeKernelBinary
+extern apMain
+extern getApStack
 
 loader:
 	call initializeKernelBinary	; Set up the kernel binary, and get thet stack address
 	mov rsp, rax				; Set up the stack with the returned address
 	call main
+	jmp hang
+
+; Application processors: Pure64 leaves them halted with interrupts enabled on
+; the kernel's IDT, and startApplicationProcessors wakes each one with an IPI
+; whose vector lands here. Its interrupt frame is abandoned with Pure64's stack.
+apLoader:
+	cli
+	call getApStack				; Stack allocated for this CPU by the boot CPU
+	mov rsp, rax
+	call apMain
 hang:
 	cli
 	hlt	; halt machine should kernel return
@@ -2,166 +2,311 @@
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 // This is a personal academic project. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * Free-list buddy allocator.
+ * Memory is split into zones, each a power-of-two buddy pool whose node bitmap
+ * is carved from the front of the region it was built from, so any amount of
+ * RAM can be managed. Per zone there is one intrusive doubly linked list of
+ * free blocks per order, plus one bit per node of the implicit buddy tree
+ * telling whether that block is currently sitting free on its list.
+ * Allocation pops the smallest non-empty order and splits down; freeing merges
+ * upwards while the buddy bit is set. Both paths take at most `maxOrder` steps.
+ */
+
 #include "../include/memoryManager.h"
+#include "../include/lib.h"
+#include "../include/rwLock.h"
 #include <stdint.h>
 #include <stddef.h>
 
 typedef struct {
-    uint8_t  order;     
-    uint8_t  _pad[7];    
+    uint8_t  order;
+    uint8_t  zone;
+    uint8_t  _pad[6];
 } AllocHdr;
 
+/* Lives inside every free block, overlapping the AllocHdr of a used one */
+typedef struct FreeBlock {
+    struct FreeBlock *next;
+    struct FreeBlock *prev;
+} FreeBlock;
+
 #define HDR_SIZE       ((uint32_t)sizeof(AllocHdr))
 
-#define MIN_BLOCK_SIZE ALIGN(HDR_SIZE + ALIGNMENT)
+#define MIN_ORDER          5          /* 32 bytes: header + FreeBlock links */
+#define MIN_ZONE_ORDER     16         /* leftovers under 64 KiB are not worth a zone */
+#define MAX_ORDER_ALLOWED  31         /* block offsets are 32-bit */
+#define MAX_ZONES          32
+#define ZONE_ALIGNMENT     64
 
-enum { FREE = 0, SPLIT = 1, FULL = 2 };
+typedef struct {
+    uint8_t   *base;
+    uint32_t  maxOrder;
+    uint32_t  freeMask;               /* bit k set <=> freeLists[k] is not empty */
+    FreeBlock *freeLists[MAX_ORDER_ALLOWED + 1];
+    uint8_t   *freeMap;               /* one bit per node of this zone's tree */
+} BuddyZone;
 
-static uint8_t  *poolBase   = NULL;
-static uint32_t poolSize    = 0;      
-static uint32_t maxOrder    = 0;      
+static BuddyZone zones[MAX_ZONES];
+static uint32_t  zoneCount = 0;
 
-#define MAX_ORDER_ALLOWED  20         
-static uint8_t   nodeState[(1u << (MAX_ORDER_ALLOWED - 5 + 1)) - 1];
+static uint64_t  totalBytes = 0, usedBytes = 0, freeBytes = 0;
 
-static uint32_t  usedBytes = 0, freeBytes = 0;
+static RwLock    heapLock = NAMED_RWLOCK_INIT("heap");
 
-static inline uint32_t order_size(uint32_t order) { return 1u << order; }
+static inline uint64_t order_size(uint32_t order) { return 1ull << order; }
 
-static inline uint32_t round_down_pow2(uint32_t x) {
-    /* largest power-of-two ≤ x (x>0) */
-    x |= (x >> 1); x |= (x >> 2); x |= (x >> 4);
-    x |= (x >> 8); x |= (x >> 16);
-    return x - (x >> 1);
+/* Bytes of node bitmap needed by a zone of the given order */
+static inline uint64_t map_bytes(uint32_t order) {
+    return ((1ull << (order - MIN_ORDER + 1)) + 7) / 8;
 }
 
-static uint32_t idx_to_offset(uint32_t idx, uint32_t order) {
-    uint32_t depth = maxOrder - order;
-    uint32_t firstIdxAtDepth = (1u << depth) - 1;
-    uint32_t posInLevel      = idx - firstIdxAtDepth;
-    return posInLevel * order_size(order);
+static inline uint64_t align_up(uint64_t x, uint64_t a) { return (x + a - 1) & ~(a - 1); }
+
+/* Index of the block (offset, order) in the zone's implicit tree, root = 0 */
+static inline uint32_t node_index(BuddyZone *z, uint32_t offset, uint32_t order) {
+    return (1u << (z->maxOrder - order)) - 1 + (offset >> order);
 }
 
-void createMemoryManager(void *memoryStart, uint32_t memoryBytes) {
-    if (!memoryStart || memoryBytes < MIN_BLOCK_SIZE) return;
+static inline int  is_free(BuddyZone *z, uint32_t idx)  { return z->freeMap[idx >> 3] & (1u << (idx & 7)); }
+static inline void mark_free(BuddyZone *z, uint32_t idx) { z->freeMap[idx >> 3] |= (uint8_t)(1u << (idx & 7)); }
+static inline void mark_used(BuddyZone *z, uint32_t idx) { z->freeMap[idx >> 3] &= (uint8_t)~(1u << (idx & 7)); }
+
+static void push_block(BuddyZone *z, uint32_t offset, uint32_t order) {
+    FreeBlock *block = (FreeBlock *)(z->base + offset);
+    block->prev = NULL;
+    block->next = z->freeLists[order];
+    if (z->freeLists[order]) z->freeLists[order]->prev = block;
+    z->freeLists[order] = block;
+    z->freeMask |= 1u << order;
+    mark_free(z, node_index(z, offset, order));
+}
 
-    poolBase = (uint8_t *)memoryStart;
-    poolSize = round_down_pow2(memoryBytes);
-    if (poolSize > (1u << MAX_ORDER_ALLOWED))
-        poolSize = (1u << MAX_ORDER_ALLOWED);
+static void unlink_block(BuddyZone *z, FreeBlock *block, uint32_t order) {
+    if (block->prev) block->prev->next = block->next;
+    else             z->freeLists[order] = block->next;
+    if (block->next) block->next->prev = block->prev;
+    if (z->freeLists[order] == NULL) z->freeMask &= ~(1u << order);
+    mark_used(z, node_index(z, (uint32_t)((uint8_t *)block - z->base), order));
+}
 
-    maxOrder = 0;
-    while (order_size(maxOrder) < poolSize) maxOrder++;
+/* Carves as many power-of-two zones as fit in [start, start + bytes) */
+static void carve_zones(uint8_t *start, uint64_t bytes) {
+    uint64_t cursor = align_up((uint64_t)start, ZONE_ALIGNMENT);
+    uint64_t end = (uint64_t)start + bytes;
+
+    while (zoneCount < MAX_ZONES && cursor < end) {
+        uint64_t avail = end - cursor;
+        uint32_t order = MAX_ORDER_ALLOWED;
+        while (order >= MIN_ZONE_ORDER &&
+               order_size(order) + align_up(map_bytes(order), ZONE_ALIGNMENT) > avail)
+            order--;
+        if (order < MIN_ZONE_ORDER) return;
+
+        BuddyZone *z = &zones[zoneCount];
+        z->freeMap = (uint8_t *)cursor;
+        memset(z->freeMap, 0, map_bytes(order));
+        cursor += align_up(map_bytes(order), ZONE_ALIGNMENT);
+
+        z->base = (uint8_t *)cursor;
+        z->maxOrder = order;
+        z->freeMask = 0;
+        for (uint32_t i = 0; i <= MAX_ORDER_ALLOWED; i++) z->freeLists[i] = NULL;
+        cursor += order_size(order);
+
+        push_block(z, 0, order);
+        zoneCount++;
+
+        totalBytes += order_size(order);
+        freeBytes  += order_size(order);
+    }
+}
+
+void createMemoryManager(void *memoryStart, uint64_t memoryBytes) {
+    zoneCount = 0;
+    totalBytes = usedBytes = freeBytes = 0;
 
-    uint32_t treeNodes = (1u << (maxOrder - 5 + 1)) - 1;
-    for (uint32_t i = 0; i < treeNodes; i++) nodeState[i] = FREE;
+    if (!memoryStart) return;
+    carve_zones((uint8_t *)memoryStart, memoryBytes);
+}
 
-    usedBytes = 0;
-    freeBytes = poolSize;
+static void addRegionLocked(void *memoryStart, uint64_t memoryBytes) {
+    if (!memoryStart) return;
+    carve_zones((uint8_t *)memoryStart, memoryBytes);
 }
 
-static uint32_t size_to_order(uint32_t userSize) {
-    uint32_t need = ALIGN(userSize) + HDR_SIZE;
-    uint32_t ord = 0;
+static uint32_t size_to_order(uint64_t userSize) {
+    uint64_t need = ALIGN(userSize) + HDR_SIZE;
+    uint32_t ord = MIN_ORDER;
     while (order_size(ord) < need) ord++;
-    /* never below MIN_BLOCK_SIZE */
-    if (order_size(ord) < MIN_BLOCK_SIZE) ord = 5;   
     return ord;
 }
 
-static int alloc_rec(uint32_t idx, uint32_t order, uint32_t wantOrder, uint32_t *outOffset)
-{
-    if (nodeState[idx] == FULL) return 0;
+static void *allocLocked(uint64_t size) {
+    if (zoneCount == 0 || size == 0 || size > order_size(MAX_ORDER_ALLOWED)) return NULL;
 
-    if (order == wantOrder) {
-        if (nodeState[idx] == FREE) {
-            nodeState[idx] = FULL;
-            *outOffset = idx_to_offset(idx, order);
-            return 1;
+    uint32_t wantOrder = size_to_order(size);
+    if (wantOrder > MAX_ORDER_ALLOWED) return NULL;
+
+    for (uint32_t zi = 0; zi < zoneCount; zi++) {
+        BuddyZone *z = &zones[zi];
+        uint32_t candidates = z->freeMask >> wantOrder;
+        if (candidates == 0) continue;
+
+        uint32_t order = wantOrder + __builtin_ctz(candidates);
+        FreeBlock *block = z->freeLists[order];
+        unlink_block(z, block, order);
+        uint32_t offset = (uint32_t)((uint8_t *)block - z->base);
+
+        /* Split down, handing the upper halves back to their lists */
+        while (order > wantOrder) {
+            order--;
+            push_block(z, offset + (uint32_t)order_size(order), order);
         }
-        return 0;                             
-    }
 
-    if (nodeState[idx] == FREE)
-        nodeState[idx] = SPLIT;
+        AllocHdr *hdr = (AllocHdr *)block;
+        hdr->order = (uint8_t)wantOrder;
+        hdr->zone  = (uint8_t)zi;
 
+        usedBytes += order_size(wantOrder) - HDR_SIZE;
+        freeBytes -= order_size(wantOrder);
 
-    uint32_t leftIdx  = 2 * idx + 1;
-    uint32_t rightIdx = leftIdx + 1;
-    uint32_t childOrd = order - 1;
+        return (void *)((uint8_t *)hdr + HDR_SIZE);
+    }
+
+    return NULL;
+}
 
-    if (alloc_rec(leftIdx, childOrd, wantOrder, outOffset)) return 1;
-    if (alloc_rec(rightIdx, childOrd, wantOrder, outOffset)) return 1;
+/* Zone owning an allocated block, or NULL if the header does not describe a live block */
+static BuddyZone *zone_of(AllocHdr *hdr) {
+    if (hdr->zone >= zoneCount) return NULL;
 
-    if (nodeState[leftIdx] == FREE && nodeState[rightIdx] == FREE)
-        nodeState[idx] = FREE;
+    BuddyZone *z = &zones[hdr->zone];
+    if ((uint8_t *)hdr < z->base || (uint8_t *)hdr >= z->base + order_size(z->maxOrder)) return NULL;
+    uint32_t offset = (uint32_t)((uint8_t *)hdr - z->base);
 
-    return 0;
+    if (hdr->order < MIN_ORDER || hdr->order > z->maxOrder || is_free(z, node_index(z, offset, hdr->order)))
+        return NULL;
+    return z;
 }
 
-void *allocMemory(uint32_t size) {
-    if (!poolBase || size == 0) return NULL;
+static void freeLocked(void *ptr) {
+    if (!ptr) return;
 
-    uint32_t wantOrder = size_to_order(size);
-    if (wantOrder > maxOrder) return NULL;
+    AllocHdr *hdr = (AllocHdr *)((uint8_t *)ptr - HDR_SIZE);
+    BuddyZone *z = zone_of(hdr);
+    if (!z) return;
 
-    uint32_t offset = 0;
-    if (!alloc_rec(0, maxOrder, wantOrder, &offset)) {
-        return NULL;                                  
-    } 
+    uint32_t order = hdr->order;
+    uint32_t offset = (uint32_t)((uint8_t *)hdr - z->base);
 
-    AllocHdr *hdr = (AllocHdr *)(poolBase + offset);
-    hdr->order = (uint8_t)wantOrder;
+    usedBytes -= order_size(order) - HDR_SIZE;
+    freeBytes += order_size(order);
 
-    usedBytes += order_size(wantOrder) - HDR_SIZE;
-    freeBytes -= order_size(wantOrder);
+    /* Merge with the buddy while it is free at the same order */
+    while (order < z->maxOrder) {
+        uint32_t buddy = offset ^ (uint32_t)order_size(order);
+        if (!is_free(z, node_index(z, buddy, order))) break;
+        unlink_block(z, (FreeBlock *)(z->base + buddy), order);
+        offset &= ~(uint32_t)order_size(order);
+        order++;
+    }
 
-    return (void *)((uint8_t *)hdr + HDR_SIZE);
+    push_block(z, offset, order);
 }
 
-static void free_rec(uint32_t idx, uint32_t order, uint32_t blockOffset, uint32_t blockOrder) {
-    if (order < blockOrder) return;               
+/*
+ * Shrinking hands the upper halves back, like a split. Growing stays in place
+ * when the block is the left half at every order up to the target and each
+ * right buddy on the way is free; otherwise the block is moved.
+ */
+static void *reallocLocked(void *ptr, uint64_t size) {
+    if (!ptr) return allocLocked(size);
+    if (size == 0) { freeLocked(ptr); return NULL; }
+    if (size > order_size(MAX_ORDER_ALLOWED)) return NULL;
 
-    if (order == blockOrder) {
-        nodeState[idx] = FREE;
-    } else {
-        uint32_t leftIdx  = 2 * idx + 1;
-        uint32_t rightIdx = leftIdx + 1;
-        uint32_t childOrd = order - 1;
-        uint32_t halfSize = order_size(childOrd);
+    AllocHdr *hdr = (AllocHdr *)((uint8_t *)ptr - HDR_SIZE);
+    BuddyZone *z = zone_of(hdr);
+    if (!z) return NULL;
 
-        if (blockOffset & halfSize)
-            free_rec(rightIdx, childOrd, blockOffset - halfSize, blockOrder);
-        else
-            free_rec(leftIdx, childOrd, blockOffset, blockOrder);
+    uint32_t order = hdr->order;
+    uint32_t wantOrder = size_to_order(size);
+    uint32_t offset = (uint32_t)((uint8_t *)hdr - z->base);
+
+    if (wantOrder <= order) {
+        while (order > wantOrder) {
+            order--;
+            push_block(z, offset + (uint32_t)order_size(order), order);
+            usedBytes -= order_size(order);
+            freeBytes += order_size(order);
+        }
+        hdr->order = (uint8_t)order;
+        return ptr;
+    }
+
+    uint32_t reach = order;
+    while (reach < wantOrder && reach < z->maxOrder && !(offset & order_size(reach)) &&
+           is_free(z, node_index(z, offset + (uint32_t)order_size(reach), reach)))
+        reach++;
 
-        
-        if (nodeState[leftIdx] == FREE && nodeState[rightIdx] == FREE)
-            nodeState[idx] = FREE;
-        else
-            nodeState[idx] = SPLIT;
+    if (reach == wantOrder) {
+        for (; order < wantOrder; order++) {
+            unlink_block(z, (FreeBlock *)(z->base + offset + order_size(order)), order);
+            usedBytes += order_size(order);
+            freeBytes -= order_size(order);
+        }
+        hdr->order = (uint8_t)wantOrder;
+        return ptr;
     }
+
+    void *moved = allocLocked(size);
+    if (!moved) return NULL;
+    memcpy(moved, ptr, order_size(order) - HDR_SIZE);
+    freeLocked(ptr);
+    return moved;
 }
 
-void freeMemory(void *ptr) {
-    if (!ptr || !poolBase) return;
 
-    AllocHdr *hdr = (AllocHdr *)((uint8_t *)ptr - HDR_SIZE);
-    uint32_t order = hdr->order;
-    uint32_t offset = (uint32_t)((uint8_t *)hdr - poolBase);
+static void getStatusLocked(MemoryStatus *status) {
+    if (!status) return;
+    status->total = totalBytes;
+    status->used  = usedBytes;
+    status->free  = freeBytes;
+    status->base  = zoneCount ? (void *)zones[0].base : NULL;
+    status->end   = zoneCount ? (void *)(zones[zoneCount - 1].base + order_size(zones[zoneCount - 1].maxOrder)) : NULL;
+}
 
-    free_rec(0, maxOrder, offset, order);
+/* Public entry points: every access to the pools goes through heapLock (see memoryManager.h) */
 
-    usedBytes -= order_size(order) - HDR_SIZE;
-    freeBytes += order_size(order);
+void addMemoryRegion(void *memoryStart, uint64_t memoryBytes) {
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    addRegionLocked(memoryStart, memoryBytes);
+    writeUnlockIrqRestore(&heapLock, flags);
+}
+
+void *allocMemory(uint64_t size) {
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    void *ptr = allocLocked(size);
+    writeUnlockIrqRestore(&heapLock, flags);
+    return ptr;
+}
+
+void freeMemory(void *ptr) {
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    freeLocked(ptr);
+    writeUnlockIrqRestore(&heapLock, flags);
 }
 
+void *reallocMemory(void *ptr, uint64_t size) {
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    ptr = reallocLocked(ptr, size);
+    writeUnlockIrqRestore(&heapLock, flags);
+    return ptr;
+}
 
 void getMemoryStatus(MemoryStatus *status) {
-    if (!status) return;
-    status->total = poolSize;
-    status->used  = usedBytes;
-    status->free  = freeBytes;
-    status->base  = (void *)poolBase;
-    status->end   = (void *)(poolBase + poolSize);
-}
\ No newline at end of file
+    uint64_t flags = readLockIrqSave(&heapLock);
+    getStatusLocked(status);
+    readUnlockIrqRestore(&heapLock, flags);
+}
@@ -0,0 +1,232 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+ * Legacy tree-walk buddy allocator (MEMORY_MANAGER=buddytree).
+ * Kept only as a baseline to compare against the free-list engine in
+ * buddyManager.c; allocation is a recursive DFS over the node tree.
+ */
+#include "../include/memoryManager.h"
+#include "../include/lib.h"
+#include "../include/rwLock.h"
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct {
+    uint8_t  order;     
+    uint8_t  _pad[7];    
+} AllocHdr;
+
+#define HDR_SIZE       ((uint32_t)sizeof(AllocHdr))
+
+#define MIN_BLOCK_SIZE ALIGN(HDR_SIZE + ALIGNMENT)
+
+enum { FREE = 0, SPLIT = 1, FULL = 2 };
+
+static uint8_t  *poolBase   = NULL;
+static uint32_t poolSize    = 0;      
+static uint32_t maxOrder    = 0;      
+
+#define MAX_ORDER_ALLOWED  20         
+static uint8_t   nodeState[(1u << (MAX_ORDER_ALLOWED - 5 + 1)) - 1];
+
+static uint32_t  usedBytes = 0, freeBytes = 0;
+
+static RwLock    heapLock = NAMED_RWLOCK_INIT("heap");
+
+static inline uint32_t order_size(uint32_t order) { return 1u << order; }
+
+static inline uint32_t round_down_pow2(uint32_t x) {
+    /* largest power-of-two ≤ x (x>0) */
+    x |= (x >> 1); x |= (x >> 2); x |= (x >> 4);
+    x |= (x >> 8); x |= (x >> 16);
+    return x - (x >> 1);
+}
+
+static uint32_t idx_to_offset(uint32_t idx, uint32_t order) {
+    uint32_t depth = maxOrder - order;
+    uint32_t firstIdxAtDepth = (1u << depth) - 1;
+    uint32_t posInLevel      = idx - firstIdxAtDepth;
+    return posInLevel * order_size(order);
+}
+
+void createMemoryManager(void *memoryStart, uint64_t memoryBytes) {
+    if (!memoryStart || memoryBytes < MIN_BLOCK_SIZE) return;
+
+    poolBase = (uint8_t *)memoryStart;
+    if (memoryBytes > (1u << MAX_ORDER_ALLOWED))
+        memoryBytes = (1u << MAX_ORDER_ALLOWED);
+    poolSize = round_down_pow2((uint32_t)memoryBytes);
+
+    maxOrder = 0;
+    while (order_size(maxOrder) < poolSize) maxOrder++;
+
+    uint32_t treeNodes = (1u << (maxOrder - 5 + 1)) - 1;
+    for (uint32_t i = 0; i < treeNodes; i++) nodeState[i] = FREE;
+
+    usedBytes = 0;
+    freeBytes = poolSize;
+}
+
+/* The tree-walk engine manages a single pool; extra regions are ignored */
+static void addRegionLocked(void *memoryStart, uint64_t memoryBytes) {
+    (void)memoryStart;
+    (void)memoryBytes;
+}
+
+static uint32_t size_to_order(uint32_t userSize) {
+    uint32_t need = ALIGN(userSize) + HDR_SIZE;
+    uint32_t ord = 0;
+    while (order_size(ord) < need) ord++;
+    /* never below MIN_BLOCK_SIZE */
+    if (ord < 5) ord = 5;
+    return ord;
+}
+
+static int alloc_rec(uint32_t idx, uint32_t order, uint32_t wantOrder, uint32_t *outOffset)
+{
+    if (nodeState[idx] == FULL) return 0;
+
+    if (order == wantOrder) {
+        if (nodeState[idx] == FREE) {
+            nodeState[idx] = FULL;
+            *outOffset = idx_to_offset(idx, order);
+            return 1;
+        }
+        return 0;                             
+    }
+
+    if (nodeState[idx] == FREE)
+        nodeState[idx] = SPLIT;
+
+
+    uint32_t leftIdx  = 2 * idx + 1;
+    uint32_t rightIdx = leftIdx + 1;
+    uint32_t childOrd = order - 1;
+
+    if (alloc_rec(leftIdx, childOrd, wantOrder, outOffset)) return 1;
+    if (alloc_rec(rightIdx, childOrd, wantOrder, outOffset)) return 1;
+
+    if (nodeState[leftIdx] == FREE && nodeState[rightIdx] == FREE)
+        nodeState[idx] = FREE;
+
+    return 0;
+}
+
+static void *allocLocked(uint64_t size) {
+    if (!poolBase || size == 0 || size >= poolSize) return NULL;
+
+    uint32_t wantOrder = size_to_order((uint32_t)size);
+    if (wantOrder > maxOrder) return NULL;
+
+    uint32_t offset = 0;
+    if (!alloc_rec(0, maxOrder, wantOrder, &offset)) {
+        return NULL;                                  
+    } 
+
+    AllocHdr *hdr = (AllocHdr *)(poolBase + offset);
+    hdr->order = (uint8_t)wantOrder;
+
+    usedBytes += order_size(wantOrder) - HDR_SIZE;
+    freeBytes -= order_size(wantOrder);
+
+    return (void *)((uint8_t *)hdr + HDR_SIZE);
+}
+
+static void free_rec(uint32_t idx, uint32_t order, uint32_t blockOffset, uint32_t blockOrder) {
+    if (order < blockOrder) return;               
+
+    if (order == blockOrder) {
+        nodeState[idx] = FREE;
+    } else {
+        uint32_t leftIdx  = 2 * idx + 1;
+        uint32_t rightIdx = leftIdx + 1;
+        uint32_t childOrd = order - 1;
+        uint32_t halfSize = order_size(childOrd);
+
+        if (blockOffset & halfSize)
+            free_rec(rightIdx, childOrd, blockOffset - halfSize, blockOrder);
+        else
+            free_rec(leftIdx, childOrd, blockOffset, blockOrder);
+
+        
+        if (nodeState[leftIdx] == FREE && nodeState[rightIdx] == FREE)
+            nodeState[idx] = FREE;
+        else
+            nodeState[idx] = SPLIT;
+    }
+}
+
+static void freeLocked(void *ptr) {
+    if (!ptr || !poolBase) return;
+
+    AllocHdr *hdr = (AllocHdr *)((uint8_t *)ptr - HDR_SIZE);
+    uint32_t order = hdr->order;
+    uint32_t offset = (uint32_t)((uint8_t *)hdr - poolBase);
+
+    free_rec(0, maxOrder, offset, order);
+
+    usedBytes -= order_size(order) - HDR_SIZE;
+    freeBytes += order_size(order);
+}
+
+/* No in-place growth here: keep the block when it already fits, move it otherwise */
+static void *reallocLocked(void *ptr, uint64_t size) {
+    if (!ptr) return allocLocked(size);
+    if (size == 0) { freeLocked(ptr); return NULL; }
+    if (!poolBase || size >= poolSize) return NULL;
+
+    AllocHdr *hdr = (AllocHdr *)((uint8_t *)ptr - HDR_SIZE);
+    if (size_to_order((uint32_t)size) <= hdr->order) return ptr;
+
+    void *moved = allocLocked(size);
+    if (!moved) return NULL;
+    memcpy(moved, ptr, order_size(hdr->order) - HDR_SIZE);
+    freeLocked(ptr);
+    return moved;
+}
+
+
+static void getStatusLocked(MemoryStatus *status) {
+    if (!status) return;
+    status->total = poolSize;
+    status->used  = usedBytes;
+    status->free  = freeBytes;
+    status->base  = (void *)poolBase;
+    status->end   = (void *)(poolBase + poolSize);
+}
+
+/* The tree walks above assume heapLock is held */
+
+void addMemoryRegion(void *memoryStart, uint64_t memoryBytes) {
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    addRegionLocked(memoryStart, memoryBytes);
+    writeUnlockIrqRestore(&heapLock, flags);
+}
+
+void *allocMemory(uint64_t size) {
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    void *ptr = allocLocked(size);
+    writeUnlockIrqRestore(&heapLock, flags);
+    return ptr;
+}
+
+void freeMemory(void *ptr) {
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    freeLocked(ptr);
+    writeUnlockIrqRestore(&heapLock, flags);
+}
+
+void *reallocMemory(void *ptr, uint64_t size) {
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    ptr = reallocLocked(ptr, size);
+    writeUnlockIrqRestore(&heapLock, flags);
+    return ptr;
+}
+
+void getMemoryStatus(MemoryStatus *status) {
+    uint64_t flags = readLockIrqSave(&heapLock);
+    getStatusLocked(status);
+    readUnlockIrqRestore(&heapLock, flags);
+}
@@ -0,0 +1,71 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * Physical memory map, as discovered by the Pure64 bootloader.
+ * Pure64 stores the BIOS E820 entries at 0x4000 with a 32-byte stride and
+ * terminates the list with an all-zero entry (see Bootloader/Pure64/src/init/isa.asm).
+ */
+
+#include "../include/memoryMap.h"
+#include <stddef.h>
+
+typedef struct {
+    uint64_t base;
+    uint64_t length;
+    uint32_t type;
+    uint32_t acpiAttributes;
+    uint64_t _pad;
+} __attribute__((packed)) E820Entry;
+
+#define E820_MAP        ((E820Entry *)0x4000)
+#define E820_MAX_ENTRIES 128                       // 4 KiB cleared by Pure64 / 32 bytes
+#define MEM_AMOUNT_MIB  (*(uint32_t *)0x5A84)      // SystemVariables + 132
+// Pure64 reserves page directories for 64 GiB but its pd_again loop only fills
+// 2048 of the 2 MiB entries (pure64.asm), so only the first 4 GiB are mapped
+#define MAPPED_LIMIT    (4ULL << 30)
+
+static void insertSorted(MemoryRegion *regions, uint32_t count, void *start, uint64_t size) {
+    uint32_t i = count;
+    while (i > 0 && (uint64_t)regions[i - 1].start > (uint64_t)start) {
+        regions[i] = regions[i - 1];
+        i--;
+    }
+    regions[i].start = start;
+    regions[i].size = size;
+}
+
+uint32_t getUsableMemoryRegions(MemoryRegion *regions, uint32_t maxRegions, void *floor) {
+    uint64_t low = (uint64_t)floor;
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < E820_MAX_ENTRIES && count < maxRegions; i++) {
+        E820Entry *entry = &E820_MAP[i];
+        if (entry->type == 0 && entry->length == 0)
+            break;
+        if (entry->type != E820_USABLE)
+            continue;
+
+        uint64_t start = entry->base;
+        uint64_t end = entry->base + entry->length;
+        if (end > MAPPED_LIMIT)
+            end = MAPPED_LIMIT;     // past it the first touch would page fault
+        if (end <= low || start >= end)
+            continue;
+        if (start < low)
+            start = low;
+
+        insertSorted(regions, count++, (void *)start, end - start);
+    }
+
+    // No E820 map: trust the total RAM Pure64 measured, as a single region
+    if (count == 0 && maxRegions > 0) {
+        uint64_t end = (uint64_t)MEM_AMOUNT_MIB << 20;
+        if (end > MAPPED_LIMIT)
+            end = MAPPED_LIMIT;
+        if (end > low)
+            insertSorted(regions, count++, floor, end - low);
+    }
+
+    return count;
+}
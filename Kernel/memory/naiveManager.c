@@ -19,6 +19,8 @@
  */
 
 #include "../include/memoryManager.h"
+#include "../include/lib.h"
+#include "../include/rwLock.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -31,7 +33,7 @@
  */
 typedef struct Block
 {
-    uint32_t size;      // Tamaño del área de datos (sin contar este header)
+    uint64_t size;      // Tamaño del área de datos (sin contar este header)
     uint8_t free;       // Estado: 1 = libre, 0 = ocupado
     struct Block *next; // Puntero al siguiente bloque en la lista enlazada
     struct Block *prev; // Puntero al bloque anterior (lista doblemente enlazada)
@@ -39,7 +41,9 @@ typedef struct Block
 
 // Variables globales que mantienen el estado del memory manager
 static Block *firstBlock = NULL;    // Puntero al primer bloque de la lista enlazada
-static uint32_t memoryPoolSize = 0; // Tamaño total del pool de memoria gestionado
+static uint64_t memoryPoolSize = 0; // Tamaño total del pool de memoria gestionado
+static uint8_t *memoryEnd = NULL;   // Fin de la última región agregada
+static RwLock heapLock = NAMED_RWLOCK_INIT("heap");
 
 // Macros auxiliares para cálculos y conversiones
 #define BLOCK_HEADER_SIZE ((uint32_t)ALIGN(sizeof(Block))) // Tamaño alineado del header
@@ -59,7 +63,7 @@ static uint32_t memoryPoolSize = 0; // Tamaño total del pool de memoria gestion
  * - Un nuevo header de bloque
  * - Alineación mínima
  */
-static uint32_t hasRoomForSplit(Block *block, uint32_t requestedSize)
+static uint32_t hasRoomForSplit(Block *block, uint64_t requestedSize)
 {
     return block->size >= requestedSize + BLOCK_HEADER_SIZE + ALIGNMENT;
 }
@@ -70,7 +74,7 @@ static uint32_t hasRoomForSplit(Block *block, uint32_t requestedSize)
  * Configura el heap inicial con un único bloque libre que ocupa toda la memoria.
  * Este bloque se irá dividiendo a medida que se hagan asignaciones.
  */
-void createMemoryManager(void *memoryStartAddress, uint32_t memorySize)
+void createMemoryManager(void *memoryStartAddress, uint64_t memorySize)
 {
     // Validaciones básicas
     if (!memoryStartAddress || memorySize <= BLOCK_HEADER_SIZE)
@@ -84,13 +88,50 @@ void createMemoryManager(void *memoryStartAddress, uint32_t memorySize)
     firstBlock->prev = NULL;                           // Es el primer bloque
 
     memoryPoolSize = memorySize; // Guarda tamaño total
+    memoryEnd = TO_BYTE_PTR(memoryStartAddress) + memorySize;
+}
+
+/*
+ * REGIONES ADICIONALES
+ * ====================
+ * Agrega otra región de memoria como un bloque libre al final de la lista.
+ * Como la fusión exige adyacencia física (NEXT_PHYSICAL_BLOCK), nunca se
+ * fusionan bloques de regiones distintas.
+ */
+static void addRegionLocked(void *memoryStartAddress, uint64_t memorySize)
+{
+    if (!firstBlock)
+    {
+        createMemoryManager(memoryStartAddress, memorySize);
+        return;
+    }
+
+    // Alinea el inicio de la región para que los headers queden alineados
+    uint8_t *start = (uint8_t *)ALIGN((uint64_t)memoryStartAddress);
+    uint64_t lost = (uint64_t)(start - TO_BYTE_PTR(memoryStartAddress));
+    if (!memoryStartAddress || memorySize <= lost + BLOCK_HEADER_SIZE)
+        return;
+
+    Block *last = firstBlock;
+    while (last->next)
+        last = last->next;
+
+    Block *region = (Block *)start;
+    region->size = memorySize - lost - BLOCK_HEADER_SIZE;
+    region->free = 1;
+    region->next = NULL;
+    region->prev = last;
+    last->next = region;
+
+    memoryPoolSize += memorySize - lost;
+    memoryEnd = start + memorySize - lost;
 }
 
 /*
  * BÚSQUEDA DE BLOQUE ADECUADO (First-Fit)
  * Recorre la lista buscando el primer bloque libre suficientemente grande.
  */
-static Block *findSuitableBlock(uint32_t requestedSize)
+static Block *findSuitableBlock(uint64_t requestedSize)
 {
     // Recorre la lista enlazada desde el primer bloque
     for (Block *block = firstBlock; block; block = block->next)
@@ -103,7 +144,7 @@ static Block *findSuitableBlock(uint32_t requestedSize)
  * DIVISIÓN DE BLOQUES
  * Divide un bloque grande en dos: uno del tamaño solicitado y otro con el sobrante.
  */
-static void splitBlock(Block *block, uint32_t requestedSize)
+static void splitBlock(Block *block, uint64_t requestedSize)
 {
     // Calcula dónde comenzará el nuevo bloque (después de los datos actuales)
     Block *newBlock = (Block *)(TO_BYTE_PTR(block) + BLOCK_HEADER_SIZE + requestedSize);
@@ -126,12 +167,12 @@ static void splitBlock(Block *block, uint32_t requestedSize)
  * ASIGNACIÓN DE MEMORIA
  * Busca un bloque libre, lo divide si es necesario y lo marca como ocupado.
  */
-void *allocMemory(uint32_t size)
+static void *allocLocked(uint64_t size)
 {
-    if (size == 0)
+    if (size == 0 || size > memoryPoolSize) // Evita que ALIGN desborde con tamaños absurdos
         return NULL;
 
-    uint32_t alignedSize = ALIGN(size);            // Alinea el tamaño para optimizar accesos
+    uint64_t alignedSize = ALIGN(size);            // Alinea el tamaño para optimizar accesos
     Block *block = findSuitableBlock(alignedSize); // Busca un bloque libre
     if (!block)
         return NULL; // No hay memoria disponible
@@ -190,7 +231,7 @@ static void coalesce(Block *block)
  * LIBERACIÓN DE MEMORIA
  * Marca el bloque como libre e intenta fusionarlo con bloques adyacentes.
  */
-void freeMemory(void *memorySegment)
+static void freeLocked(void *memorySegment)
 {
     if (!memorySegment)
         return;
@@ -203,17 +244,62 @@ void freeMemory(void *memorySegment)
     coalesce(block);
 }
 
+/*
+ * REDIMENSIONAMIENTO
+ * Crece en el lugar absorbiendo el bloque físico siguiente si está libre y alcanza;
+ * al achicar, devuelve el sobrante como bloque libre. Si no, mueve los datos.
+ */
+static void *reallocLocked(void *memorySegment, uint64_t size)
+{
+    if (!memorySegment)
+        return allocLocked(size);
+    if (size == 0)
+    {
+        freeLocked(memorySegment);
+        return NULL;
+    }
+    if (size > memoryPoolSize)
+        return NULL;
+
+    Block *block = (Block *)(TO_BYTE_PTR(memorySegment) - BLOCK_HEADER_SIZE);
+    if (block->free)
+        return NULL;
+
+    uint64_t alignedSize = ALIGN(size);
+    Block *nextBlock = block->next;
+    if (block->size < alignedSize && nextBlock && nextBlock->free && nextBlock == NEXT_PHYSICAL_BLOCK(block) &&
+        block->size + BLOCK_HEADER_SIZE + nextBlock->size >= alignedSize)
+        mergeWithNext(block);
+
+    if (block->size >= alignedSize)
+    {
+        if (hasRoomForSplit(block, alignedSize))
+        {
+            splitBlock(block, alignedSize);
+            mergeWithNext(block->next); // El sobrante puede unirse con un libre que le siga
+        }
+        return memorySegment;
+    }
+
+    void *moved = allocLocked(size);
+    if (!moved)
+        return NULL;
+    memcpy(moved, memorySegment, block->size);
+    freeLocked(memorySegment);
+    return moved;
+}
+
 /*
  * ESTADÍSTICAS DE MEMORIA
  * Recorre la lista y calcula el uso actual de memoria.
  */
-void getMemoryStatus(MemoryStatus *status)
+static void getStatusLocked(MemoryStatus *status)
 {
     if (!status)
         return;
 
-    uint32_t usedBytes = 0;
-    uint32_t freeBytes = 0;
+    uint64_t usedBytes = 0;
+    uint64_t freeBytes = 0;
 
     for (Block *block = firstBlock; block; block = block->next)
     {
@@ -228,5 +314,46 @@ void getMemoryStatus(MemoryStatus *status)
     status->free = freeBytes;
 
     status->base = (void *)firstBlock;
-    status->end = (void *)(TO_BYTE_PTR(firstBlock) + memoryPoolSize);
+    status->end = (void *)memoryEnd;
+}
+
+/*
+ * PUNTOS DE ENTRADA
+ * Todo acceso al heap pasa por heapLock (ver memoryManager.h).
+ */
+void addMemoryRegion(void *memoryStartAddress, uint64_t memorySize)
+{
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    addRegionLocked(memoryStartAddress, memorySize);
+    writeUnlockIrqRestore(&heapLock, flags);
+}
+
+void *allocMemory(uint64_t size)
+{
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    void *memory = allocLocked(size);
+    writeUnlockIrqRestore(&heapLock, flags);
+    return memory;
+}
+
+void freeMemory(void *memorySegment)
+{
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    freeLocked(memorySegment);
+    writeUnlockIrqRestore(&heapLock, flags);
+}
+
+void *reallocMemory(void *memorySegment, uint64_t size)
+{
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    void *memory = reallocLocked(memorySegment, size);
+    writeUnlockIrqRestore(&heapLock, flags);
+    return memory;
+}
+
+void getMemoryStatus(MemoryStatus *status)
+{
+    uint64_t flags = readLockIrqSave(&heapLock);
+    getStatusLocked(status);
+    readUnlockIrqRestore(&heapLock, flags);
 }
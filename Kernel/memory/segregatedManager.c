@@ -0,0 +1,388 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * SEGREGATED-FIT MEMORY MANAGER
+ * =============================
+ * Variante del naive manager que sólo recorre bloques libres:
+ * - Listas libres explícitas, una por clase de tamaño (segregated free lists)
+ * - Los enlaces de la lista viven dentro del área de datos de los bloques libres
+ * - Boundary tags: los bloques libres guardan su tamaño también al final (footer),
+ *   así la fusión con el bloque físico anterior es O(1)
+ * - Un bitmap de clases no vacías permite saltar a la próxima clase útil en O(1)
+ *
+ * Características:
+ * - Asignación: first-fit dentro de la clase pedida, o la cabeza de la
+ *   primera clase mayor no vacía (que siempre alcanza)
+ * - Liberación + coalescencia: O(1)
+ * - Overhead: 8 bytes por bloque ocupado, mínimo 24 bytes de datos por bloque
+ */
+
+#include "../include/memoryManager.h"
+#include "../include/lib.h"
+#include "../include/rwLock.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Layout en memoria de cada región:
+ * [Header][Datos...][Header][Datos...]...[Header epílogo (size 0, ocupado)]
+ *
+ * Un bloque libre usa sus datos para los enlaces y el footer:
+ * [Header][FreeLinks][...][Footer]
+ */
+typedef struct
+{
+    uint32_t size;  // Tamaño del área de datos (sin contar este header)
+    uint32_t flags; // BLOCK_FREE / PREV_FREE
+} Header;
+
+typedef struct FreeLinks
+{
+    struct FreeLinks *next; // Siguiente bloque libre de la misma clase
+    struct FreeLinks *prev; // Anterior bloque libre de la misma clase
+} FreeLinks;
+
+#define BLOCK_FREE 0x1 // Este bloque está libre
+#define PREV_FREE 0x2  // El bloque físico anterior está libre (su footer es válido)
+
+#define HEADER_SIZE ((uint32_t)sizeof(Header))
+#define FOOTER_SIZE ((uint32_t)sizeof(uint64_t))
+#define MIN_PAYLOAD ((uint32_t)ALIGN(sizeof(FreeLinks) + FOOTER_SIZE))
+
+#define MAX_BLOCK_SIZE 0x80000000u   // Los headers guardan tamaños de 32 bits
+#define MAX_REGION_CHUNK 0x80000000u // Regiones más grandes se parten en trozos de este tamaño
+
+#define SMALL_CLASSES 16        // Clases exactas de 16 bytes hasta 256
+#define SMALL_LIMIT 256
+#define NUM_CLASSES (SMALL_CLASSES + 24) // Más una clase por potencia de 2 hasta 2^31
+
+#define TO_BYTE_PTR(ptr) ((uint8_t *)(ptr))
+#define PAYLOAD(hdr) ((void *)(TO_BYTE_PTR(hdr) + HEADER_SIZE))
+#define HEADER_OF(payload) ((Header *)(TO_BYTE_PTR(payload) - HEADER_SIZE))
+#define NEXT_PHYSICAL(hdr) ((Header *)(TO_BYTE_PTR(hdr) + HEADER_SIZE + (hdr)->size))
+#define FOOTER(hdr) ((uint64_t *)(TO_BYTE_PTR(hdr) + HEADER_SIZE + (hdr)->size - FOOTER_SIZE))
+
+static FreeLinks *freeLists[NUM_CLASSES];
+static uint64_t nonEmptyClasses = 0; // bit c encendido <=> freeLists[c] no está vacía
+
+static uint64_t totalBytes = 0, usedBytes = 0, freeBytes = 0;
+static uint8_t *memoryBase = NULL, *memoryEnd = NULL;
+static RwLock heapLock = NAMED_RWLOCK_INIT("heap");
+
+/*
+ * CLASE DE TAMAÑO
+ * Tamaños chicos: una clase cada 16 bytes. Tamaños grandes: una clase por potencia de 2.
+ */
+static uint32_t sizeClass(uint32_t size)
+{
+    if (size < SMALL_LIMIT)
+        return size / (SMALL_LIMIT / SMALL_CLASSES);
+
+    uint32_t log2 = 31 - __builtin_clz(size);
+    uint32_t c = SMALL_CLASSES + (log2 - 8);
+    return c < NUM_CLASSES ? c : NUM_CLASSES - 1;
+}
+
+static void insertFree(Header *hdr)
+{
+    uint32_t c = sizeClass(hdr->size);
+    FreeLinks *links = (FreeLinks *)PAYLOAD(hdr);
+
+    links->prev = NULL;
+    links->next = freeLists[c];
+    if (freeLists[c])
+        freeLists[c]->prev = links;
+    freeLists[c] = links;
+    nonEmptyClasses |= 1ull << c;
+
+    hdr->flags |= BLOCK_FREE;
+    *FOOTER(hdr) = hdr->size;
+    NEXT_PHYSICAL(hdr)->flags |= PREV_FREE;
+}
+
+static void removeFree(Header *hdr)
+{
+    uint32_t c = sizeClass(hdr->size);
+    FreeLinks *links = (FreeLinks *)PAYLOAD(hdr);
+
+    if (links->prev)
+        links->prev->next = links->next;
+    else
+        freeLists[c] = links->next;
+    if (links->next)
+        links->next->prev = links->prev;
+    if (!freeLists[c])
+        nonEmptyClasses &= ~(1ull << c);
+
+    hdr->flags &= ~BLOCK_FREE;
+    NEXT_PHYSICAL(hdr)->flags &= ~PREV_FREE;
+}
+
+/*
+ * REGIONES
+ * Cada región es un único bloque libre seguido por un header epílogo ocupado
+ * de tamaño 0, que frena la coalescencia al final de la región.
+ */
+static void addRegionChunk(void *memoryStartAddress, uint32_t memorySize)
+{
+    uint8_t *start = (uint8_t *)ALIGN((uint64_t)memoryStartAddress);
+    uint64_t lost = start - TO_BYTE_PTR(memoryStartAddress);
+    if (!memoryStartAddress || memorySize < lost + 2 * HEADER_SIZE + MIN_PAYLOAD)
+        return;
+
+    uint32_t usable = (uint32_t)((memorySize - lost) & ~(uint64_t)(ALIGNMENT - 1));
+
+    Header *first = (Header *)start;
+    first->size = usable - 2 * HEADER_SIZE;
+    first->flags = 0;
+
+    Header *epilogue = NEXT_PHYSICAL(first);
+    epilogue->size = 0;
+    epilogue->flags = 0;
+
+    insertFree(first);
+
+    totalBytes += usable;
+    freeBytes += first->size;
+    if (!memoryBase || start < memoryBase)
+        memoryBase = start;
+    if (start + usable > memoryEnd)
+        memoryEnd = start + usable;
+}
+
+static void addRegion(void *memoryStartAddress, uint64_t memorySize)
+{
+    uint8_t *start = TO_BYTE_PTR(memoryStartAddress);
+    while (start && memorySize > 0)
+    {
+        uint32_t chunk = memorySize > MAX_REGION_CHUNK ? MAX_REGION_CHUNK : (uint32_t)memorySize;
+        addRegionChunk(start, chunk);
+        start += chunk;
+        memorySize -= chunk;
+    }
+}
+
+void createMemoryManager(void *memoryStartAddress, uint64_t memorySize)
+{
+    for (uint32_t c = 0; c < NUM_CLASSES; c++)
+        freeLists[c] = NULL;
+    nonEmptyClasses = 0;
+    totalBytes = usedBytes = freeBytes = 0;
+    memoryBase = memoryEnd = NULL;
+
+    addRegion(memoryStartAddress, memorySize);
+}
+
+static void addRegionLocked(void *memoryStartAddress, uint64_t memorySize)
+{
+    addRegion(memoryStartAddress, memorySize);
+}
+
+/*
+ * BÚSQUEDA DE BLOQUE
+ * Primero first-fit dentro de la propia clase (sus bloques pueden ser más chicos
+ * que lo pedido); si no hay, cualquier bloque de una clase mayor alcanza.
+ */
+static Header *findFreeBlock(uint32_t requestedSize)
+{
+    uint32_t c = sizeClass(requestedSize);
+
+    for (FreeLinks *links = freeLists[c]; links; links = links->next)
+        if (HEADER_OF(links)->size >= requestedSize)
+            return HEADER_OF(links);
+
+    uint64_t larger = (c + 1 < NUM_CLASSES) ? nonEmptyClasses & (~0ull << (c + 1)) : 0;
+    if (!larger)
+        return NULL;
+
+    return HEADER_OF(freeLists[__builtin_ctzll(larger)]);
+}
+
+static void *allocLocked(uint64_t size)
+{
+    if (size == 0 || size > MAX_BLOCK_SIZE)
+        return NULL;
+
+    uint32_t alignedSize = (uint32_t)ALIGN(size);
+    if (alignedSize < MIN_PAYLOAD)
+        alignedSize = MIN_PAYLOAD;
+
+    Header *block = findFreeBlock(alignedSize);
+    if (!block)
+        return NULL;
+
+    removeFree(block);
+
+    // Divide si el sobrante alcanza para otro bloque libre
+    if (block->size >= alignedSize + HEADER_SIZE + MIN_PAYLOAD)
+    {
+        Header *rest = (Header *)(TO_BYTE_PTR(block) + HEADER_SIZE + alignedSize);
+        rest->size = block->size - alignedSize - HEADER_SIZE;
+        rest->flags = 0;
+        block->size = alignedSize;
+        insertFree(rest);
+        freeBytes -= HEADER_SIZE;
+    }
+
+    usedBytes += block->size;
+    freeBytes -= block->size;
+    return PAYLOAD(block);
+}
+
+/*
+ * LIBERACIÓN + COALESCENCIA
+ * El vecino siguiente se encuentra por tamaño; el anterior por su footer,
+ * que sólo se lee cuando PREV_FREE indica que es válido.
+ */
+static void freeLocked(void *memorySegment)
+{
+    if (!memorySegment)
+        return;
+
+    Header *block = HEADER_OF(memorySegment);
+    if (block->flags & BLOCK_FREE)
+        return;
+
+    usedBytes -= block->size;
+    freeBytes += block->size;
+
+    Header *next = NEXT_PHYSICAL(block);
+    if (next->flags & BLOCK_FREE)
+    {
+        removeFree(next);
+        block->size += HEADER_SIZE + next->size;
+        freeBytes += HEADER_SIZE;
+    }
+
+    if (block->flags & PREV_FREE)
+    {
+        Header *prev = (Header *)(TO_BYTE_PTR(block) - *(uint64_t *)(TO_BYTE_PTR(block) - FOOTER_SIZE) - HEADER_SIZE);
+        removeFree(prev);
+        prev->size += HEADER_SIZE + block->size;
+        freeBytes += HEADER_SIZE;
+        block = prev;
+    }
+
+    insertFree(block);
+}
+
+/*
+ * REDIMENSIONAMIENTO
+ * Si el bloque físico siguiente está libre y alcanza, se lo absorbe en el lugar.
+ * El sobrante (al achicar o tras absorber) vuelve a las listas como bloque libre.
+ */
+static void *reallocLocked(void *memorySegment, uint64_t size)
+{
+    if (!memorySegment)
+        return allocLocked(size);
+    if (size == 0)
+    {
+        freeLocked(memorySegment);
+        return NULL;
+    }
+    if (size > MAX_BLOCK_SIZE)
+        return NULL;
+
+    Header *block = HEADER_OF(memorySegment);
+    if (block->flags & BLOCK_FREE)
+        return NULL;
+
+    uint32_t alignedSize = (uint32_t)ALIGN(size);
+    if (alignedSize < MIN_PAYLOAD)
+        alignedSize = MIN_PAYLOAD;
+
+    Header *next = NEXT_PHYSICAL(block);
+    if (block->size < alignedSize && (next->flags & BLOCK_FREE) &&
+        (uint64_t)block->size + HEADER_SIZE + next->size >= alignedSize)
+    {
+        removeFree(next);
+        freeBytes -= next->size;
+        usedBytes += HEADER_SIZE + next->size;
+        block->size += HEADER_SIZE + next->size;
+    }
+
+    if (block->size < alignedSize)
+    {
+        void *moved = allocLocked(size);
+        if (!moved)
+            return NULL;
+        memcpy(moved, memorySegment, block->size);
+        freeLocked(memorySegment);
+        return moved;
+    }
+
+    if (block->size >= alignedSize + HEADER_SIZE + MIN_PAYLOAD)
+    {
+        Header *rest = (Header *)(TO_BYTE_PTR(block) + HEADER_SIZE + alignedSize);
+        rest->size = block->size - alignedSize - HEADER_SIZE;
+        rest->flags = 0;
+        usedBytes -= block->size - alignedSize;
+        freeBytes += rest->size;
+        block->size = alignedSize;
+
+        Header *after = NEXT_PHYSICAL(rest);
+        if (after->flags & BLOCK_FREE)
+        {
+            removeFree(after);
+            rest->size += HEADER_SIZE + after->size;
+            freeBytes += HEADER_SIZE;
+        }
+        insertFree(rest);
+    }
+
+    return memorySegment;
+}
+
+static void getStatusLocked(MemoryStatus *status)
+{
+    if (!status)
+        return;
+
+    status->total = totalBytes;
+    status->used = usedBytes;
+    status->free = freeBytes;
+    status->base = (void *)memoryBase;
+    status->end = (void *)memoryEnd;
+}
+
+/*
+ * PUNTOS DE ENTRADA
+ * Las funciones *Locked de arriba asumen heapLock tomado; acá se toma.
+ */
+void addMemoryRegion(void *memoryStartAddress, uint64_t memorySize)
+{
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    addRegionLocked(memoryStartAddress, memorySize);
+    writeUnlockIrqRestore(&heapLock, flags);
+}
+
+void *allocMemory(uint64_t size)
+{
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    void *memory = allocLocked(size);
+    writeUnlockIrqRestore(&heapLock, flags);
+    return memory;
+}
+
+void freeMemory(void *memorySegment)
+{
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    freeLocked(memorySegment);
+    writeUnlockIrqRestore(&heapLock, flags);
+}
+
+void *reallocMemory(void *memorySegment, uint64_t size)
+{
+    uint64_t flags = writeLockIrqSave(&heapLock);
+    void *memory = reallocLocked(memorySegment, size);
+    writeUnlockIrqRestore(&heapLock, flags);
+    return memory;
+}
+
+void getMemoryStatus(MemoryStatus *status)
+{
+    uint64_t flags = readLockIrqSave(&heapLock);
+    getStatusLocked(status);
+    readUnlockIrqRestore(&heapLock, flags);
+}
@@ -0,0 +1,217 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * Slab allocator on top of the general memory manager.
+ * A slab is a SLAB_SIZE-aligned frame that starts with a Slab descriptor and
+ * is followed by equally sized object slots; the slab owning an object is
+ * found by masking the object's address. Frames are obtained in chunks of
+ * SLABS_PER_CHUNK from allocMemory (which gives no alignment guarantee) and
+ * are kept by their cache for reuse once emptied.
+ *
+ * Free slots are linked through a word inside the slot: at offset 0 when the
+ * cache has no constructor, or right after the object when it does, so a
+ * constructed object is never overwritten while it sits on the free list.
+ *
+ * Each cache has its own lock, named after the cache, so allocations from
+ * different caches do not contend. Growing takes the heap lock inside it.
+ */
+
+#include "../include/slab.h"
+#include "../include/memoryManager.h"
+#include "../include/spinlock.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define SLABS_PER_CHUNK 6
+
+typedef struct FreeSlot {
+    struct FreeSlot *next;
+} FreeSlot;
+
+typedef struct Slab {
+    KmemCache   *cache;
+    struct Slab *next;        // partial list links: slabs with at least one free slot
+    struct Slab *prev;
+    FreeSlot    *freeList;
+    uint32_t    inUse;
+} Slab;
+
+struct KmemCache {
+    char            name[SLAB_NAME_LENGTH];
+    uint32_t        objectSize;
+    uint32_t        slotSize;
+    uint32_t        linkOffset;   // where the free-list link lives inside a slot
+    uint32_t        slotsPerSlab;
+    KmemConstructor constructor;
+    Slab            *partial;
+    uint32_t        slabs;
+    uint32_t        objectsInUse;
+    uint64_t        allocs;
+    uint64_t        frees;
+    Spinlock        lock;
+};
+
+/* Caches live in a static table, so creating one never needs the allocator */
+static KmemCache caches[MAX_SLAB_CACHES];
+static uint32_t  cacheCount = 0;
+static Spinlock  cacheTableLock = SPINLOCK_INIT;
+
+#define SLAB_OF(object)     ((Slab *)((uint64_t)(object) & ~(uint64_t)(SLAB_SIZE - 1)))
+#define FIRST_SLOT(slab)    ((uint8_t *)(slab) + ALIGN(sizeof(Slab)))
+#define SLOT_LINK(c, slot)  ((FreeSlot *)((uint8_t *)(slot) + (c)->linkOffset))
+#define LINK_SLOT(c, link)  ((void *)((uint8_t *)(link) - (c)->linkOffset))
+
+KmemCache *kmem_cache_create(const char *name, uint32_t objectSize, KmemConstructor constructor) {
+    if (cacheCount >= MAX_SLAB_CACHES || objectSize == 0 || objectSize > SLAB_MAX_OBJECT_SIZE)
+        return NULL;
+
+    uint64_t flags = spinLockIrqSave(&cacheTableLock);
+    if (cacheCount >= MAX_SLAB_CACHES) {
+        spinUnlockIrqRestore(&cacheTableLock, flags);
+        return NULL;
+    }
+    // Filled in before it is counted: getSlabStatus walks the first cacheCount entries
+    KmemCache *cache = &caches[cacheCount];
+
+    uint32_t i = 0;
+    for (; name && name[i] && i < SLAB_NAME_LENGTH - 1; i++)
+        cache->name[i] = name[i];
+    cache->name[i] = 0;
+
+    cache->objectSize = objectSize;
+    cache->constructor = constructor;
+    if (constructor) {
+        cache->linkOffset = (uint32_t)ALIGN(objectSize);
+        cache->slotSize = cache->linkOffset + sizeof(FreeSlot);
+    } else {
+        cache->linkOffset = 0;
+        cache->slotSize = (uint32_t)ALIGN(objectSize < sizeof(FreeSlot) ? sizeof(FreeSlot) : objectSize);
+    }
+    cache->slotsPerSlab = (SLAB_SIZE - ALIGN(sizeof(Slab))) / cache->slotSize;
+
+    cache->partial = NULL;
+    cache->slabs = 0;
+    cache->objectsInUse = 0;
+    cache->allocs = cache->frees = 0;
+    cache->lock = (Spinlock) NAMED_SPINLOCK_INIT(cache->name);
+
+    __atomic_store_n(&cacheCount, cacheCount + 1, __ATOMIC_RELEASE);
+    spinUnlockIrqRestore(&cacheTableLock, flags);
+    return cache;
+}
+
+static void pushPartial(KmemCache *cache, Slab *slab) {
+    slab->prev = NULL;
+    slab->next = cache->partial;
+    if (cache->partial) cache->partial->prev = slab;
+    cache->partial = slab;
+}
+
+static void unlinkPartial(KmemCache *cache, Slab *slab) {
+    if (slab->prev) slab->prev->next = slab->next;
+    else            cache->partial = slab->next;
+    if (slab->next) slab->next->prev = slab->prev;
+}
+
+static void initSlab(KmemCache *cache, Slab *slab) {
+    slab->cache = cache;
+    slab->inUse = 0;
+    slab->freeList = NULL;
+
+    // Link slots in address order, constructing each object once
+    uint8_t *slot = FIRST_SLOT(slab) + (uint64_t)(cache->slotsPerSlab - 1) * cache->slotSize;
+    for (uint32_t i = 0; i < cache->slotsPerSlab; i++, slot -= cache->slotSize) {
+        if (cache->constructor)
+            cache->constructor(slot);
+        FreeSlot *link = SLOT_LINK(cache, slot);
+        link->next = slab->freeList;
+        slab->freeList = link;
+    }
+
+    pushPartial(cache, slab);
+    cache->slabs++;
+}
+
+/* Gets a chunk from the memory manager and turns every aligned frame in it into a slab */
+static int grow(KmemCache *cache) {
+    uint32_t request = SLABS_PER_CHUNK * SLAB_SIZE + SLAB_SIZE - 1;
+    uint8_t *raw = allocMemory(request);
+    if (!raw)
+        return 0;
+
+    uint64_t frame = ((uint64_t)raw + SLAB_SIZE - 1) & ~(uint64_t)(SLAB_SIZE - 1);
+    uint64_t end = (uint64_t)raw + request;
+    for (; frame + SLAB_SIZE <= end; frame += SLAB_SIZE)
+        initSlab(cache, (Slab *)frame);
+
+    return 1;
+}
+
+void *kmem_cache_alloc(KmemCache *cache) {
+    if (!cache)
+        return NULL;
+
+    uint64_t flags = spinLockIrqSave(&cache->lock);
+    if (!cache->partial && !grow(cache)) {
+        spinUnlockIrqRestore(&cache->lock, flags);
+        return NULL;
+    }
+
+    Slab *slab = cache->partial;
+    FreeSlot *link = slab->freeList;
+    slab->freeList = link->next;
+    slab->inUse++;
+    if (!slab->freeList)
+        unlinkPartial(cache, slab);
+
+    cache->objectsInUse++;
+    cache->allocs++;
+    spinUnlockIrqRestore(&cache->lock, flags);
+    return LINK_SLOT(cache, link);
+}
+
+void kmem_cache_free(KmemCache *cache, void *object) {
+    if (!cache || !object)
+        return;
+
+    Slab *slab = SLAB_OF(object);
+    uint64_t flags = spinLockIrqSave(&cache->lock);
+    if (slab->cache != cache || slab->inUse == 0) {
+        spinUnlockIrqRestore(&cache->lock, flags);
+        return;
+    }
+
+    FreeSlot *link = SLOT_LINK(cache, object);
+    if (!slab->freeList)
+        pushPartial(cache, slab);
+    link->next = slab->freeList;
+    slab->freeList = link;
+    slab->inUse--;
+
+    cache->objectsInUse--;
+    cache->frees++;
+    spinUnlockIrqRestore(&cache->lock, flags);
+}
+
+void getSlabStatus(MemoryStatus *status) {
+    if (!status)
+        return;
+
+    uint32_t count = __atomic_load_n(&cacheCount, __ATOMIC_ACQUIRE);
+    status->slabCacheCount = count;
+    for (uint32_t i = 0; i < count; i++) {
+        KmemCache *cache = &caches[i];
+        SlabCacheStatus *out = &status->slabCaches[i];
+        uint64_t flags = spinLockIrqSave(&cache->lock);
+        for (uint32_t j = 0; j < SLAB_NAME_LENGTH; j++)
+            out->name[j] = cache->name[j];
+        out->objectSize = cache->objectSize;
+        out->slabs = cache->slabs;
+        out->objects = cache->slabs * cache->slotsPerSlab;
+        out->objectsInUse = cache->objectsInUse;
+        out->allocs = cache->allocs;
+        out->frees = cache->frees;
+        spinUnlockIrqRestore(&cache->lock, flags);
+    }
+}
@@ -0,0 +1,158 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * Per-CPU data and bring-up of the application processors.
+ * Pure64 already sent INIT/SIPI to every core it found and left them halted
+ * in its ap_sleep loop, with interrupts enabled on the same IDT the kernel
+ * fills in at address 0. So there is no trampoline to write: a fixed IPI with
+ * APIC_AP_START_VECTOR takes a parked core straight into apLoader
+ * (loader.asm), which moves to the stack allocated for it here and calls
+ * apMain. Cores are started one at a time, since apLoader finds its stack and
+ * Cpu through `starting`.
+ */
+
+#include <cpu.h>
+#include <apic.h>
+#include <time.h>
+#include <scheduler.h>
+#include <idtLoader.h>
+#include <kernelLock.h>
+#include <memoryManager.h>
+#include <lib.h>
+#include <stddef.h>
+
+#define MSR_GS_BASE             0xC0000101
+
+#define PURE64_BSP_APIC_ID      ((uint32_t *) 0x5008)   // Pure64 info map entries
+#define PURE64_CPU_DETECTED     ((uint16_t *) 0x5014)
+#define PURE64_CPU_APIC_IDS     ((uint8_t *) 0x5100)    // APIC IDs of the usable cores in the MADT
+#define PURE64_CPU_STATUS       ((uint8_t *) 0x5700)    // one byte per APIC ID, 1 if Pure64 started that core
+
+#define AP_STACK_SIZE           0x1000
+#define AP_START_TIMEOUT_NS     (100 * 1000 * 1000)
+
+static Cpu cpus[MAX_CPUS];
+static uint8_t cpuCount = 0;
+static Cpu *starting = NULL;    // the application processor being brought up
+
+static void setCpu(Cpu *cpu) {
+    cpu->self = cpu;
+    _writeMSR(MSR_GS_BASE, (uint64_t) cpu);
+}
+
+void initBootCpu(void) {
+    Cpu *cpu = &cpus[BOOT_CPU];
+    cpu->index = BOOT_CPU;
+    cpu->apicId = *PURE64_BSP_APIC_ID;
+    cpu->online = 1;
+    cpu->runQueue.lock = (Spinlock) NAMED_SPINLOCK_INIT("runqueue");
+    setCpu(cpu);
+    cpuCount = 1;
+}
+
+Cpu *getCpuByIndex(uint8_t index) {
+    return index < cpuCount ? &cpus[index] : NULL;
+}
+
+uint8_t getCpuCount(void) {
+    return cpuCount;
+}
+
+void *getApStack(void) {
+    return starting->stack + AP_STACK_SIZE;
+}
+
+void apMain(void) {
+    Cpu *cpu = starting;
+    setCpu(cpu);
+
+    initLocalApic();
+    lapicEOI();         // for the start IPI
+    load_syscalls();    // the SYSCALL MSRs are per CPU
+    initCpuTimer();
+
+    cpu->online = 1;
+
+    // Joins once every core is up: until then cpuCount does not count this one, and main holds the kernel lock
+    kernelLock();
+    kernelUnlock();
+    startScheduler();
+}
+
+static uint8_t startCpu(uint8_t apicId) {
+    Cpu *cpu = &cpus[cpuCount];
+    cpu->index = cpuCount;
+    cpu->apicId = apicId;
+    cpu->online = 0;
+    cpu->runQueue.lock = (Spinlock) NAMED_SPINLOCK_INIT("runqueue");
+    cpu->idle = createIdleProcess();
+    cpu->stack = allocMemory(AP_STACK_SIZE);
+    if (!cpu->idle || !cpu->stack)
+        return 0;   // leaks them, but there is no memory left for processes anyway
+
+    starting = cpu;
+    lapicSendIpi(apicId, APIC_AP_START_VECTOR);
+
+    uint64_t deadline = monotonicNanoseconds() + AP_START_TIMEOUT_NS;
+    while (!cpu->online && monotonicNanoseconds() < deadline)
+        __builtin_ia32_pause();
+    if (!cpu->online)
+        return 0;
+
+    cpuCount++;
+    return 1;
+}
+
+uint8_t startApplicationProcessors(void) {
+    // Without a calibrated local APIC timer nothing could preempt them
+    if (!hasLocalTimer())
+        return cpuCount;
+
+    _cli();
+    kernelLock();   // the ones already up may be running processes
+    for (uint16_t i = 0; i < *PURE64_CPU_DETECTED && cpuCount < MAX_CPUS; i++) {
+        uint8_t apicId = PURE64_CPU_APIC_IDS[i];
+        if (apicId == cpus[BOOT_CPU].apicId || PURE64_CPU_STATUS[apicId] != 1)
+            continue;
+        if (!startCpu(apicId))
+            break;  // one that never showed up could still take `starting` later
+    }
+    kernelUnlock();
+    _sti();
+    return cpuCount;
+}
+
+void sendReschedule(Cpu *cpu) {
+    if (cpu->reschedulePending)
+        return;
+    cpu->reschedulePending = 1;
+    if (cpu == getCpu())
+        timerDeadlinesChanged();
+    else
+        lapicSendIpi(cpu->apicId, APIC_RESCHEDULE_VECTOR);
+}
+
+uint32_t getCpuStats(CpuInfo *info, uint32_t maxEntries) {
+    uint64_t now = getTicks();
+    uint32_t count = 0;
+    for (uint8_t i = 0; i < cpuCount && count < maxEntries; i++) {
+        Cpu *cpu = &cpus[i];
+        CpuInfo *out = &info[count++];
+        uint8_t idle = cpu->current == NULL || cpu->current == cpu->idle;
+
+        // Ticks are charged at switches and timer interrupts; add what the running process has had since
+        uint64_t pending = cpu->current ? now - cpu->lastTick : 0;
+        out->apicId = cpu->apicId;
+        out->pid = idle ? 0 : cpu->current->pid;
+        out->busyTicks = cpu->busyTicks + (idle ? 0 : pending);
+        out->idleTicks = cpu->idleTicks + (idle ? pending : 0);
+        out->dispatches = cpu->dispatches;
+        out->queued = cpu->runQueue.length;
+        out->maxQueued = cpu->runQueue.maxLength;
+        out->enqueued = cpu->runQueue.enqueued;
+        out->steals = cpu->runQueue.steals;
+        out->stolen = cpu->runQueue.stolen;
+    }
+    return count;
+}
@@ -0,0 +1,359 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * Process lifecycle: creation, exit, kill, waitpid and block/unblock.
+ * PCBs come from a slab cache and live in a fixed table indexed by slot;
+ * each process gets its own stack from the memory manager, on which a fake
+ * interrupt frame is built so the first switch to it "returns" into
+ * processStart.
+ *
+ * An exited process stays as a zombie until its parent collects it with
+ * waitpid. Processes without a parent are released as soon as the scheduler
+ * has moved off their stack.
+ *
+ * Every CPU has its own idle process, all of them with pid 0; pid lookups
+ * only ever find the boot CPU's, which kill, block and nice refuse, so
+ * nothing can touch the others. A process blocked or killed while it runs on
+ * another CPU keeps running there until that CPU takes the reschedule IPI.
+ */
+
+#include <process.h>
+#include <scheduler.h>
+#include <cpu.h>
+#include <kernelLock.h>
+#include <waitQueue.h>
+#include <sleepQueue.h>
+#include <robustLock.h>
+#include <interrupts.h>
+#include <memoryManager.h>
+#include <slab.h>
+#include <lib.h>
+#include <stddef.h>
+
+#define KERNEL_CS       0x08
+#define KERNEL_SS       0x00    // Pure64 leaves the null selector in SS
+#define INITIAL_RFLAGS  0x202   // IF set
+
+/* Initial stack contents, in the order _irq00Handler / _irq81Handler pop them */
+typedef struct {
+    uint64_t r15, r14, r13, r12, r11, r10, r9, r8;
+    uint64_t rsi, rdi, rbp, rdx, rcx, rbx, rax;
+    uint64_t rip, cs, rflags, rsp, ss;
+} InitialFrame;
+
+static KmemCache *processCache = NULL;
+static Process *processes[MAX_PROCESSES];
+static Process *idleProcess = NULL;
+static pid_t nextPid = IDLE_PID + 1;
+
+static Process *findProcess(pid_t pid) {
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++)
+        if (processes[i] && processes[i]->pid == pid)
+            return processes[i];
+    return NULL;
+}
+
+static void processStart(ProcessEntry entry, uint64_t argc, char *argv[]) {
+    exitProcess(entry(argc, argv));
+}
+
+static int64_t idle(uint64_t argc, char *argv[]) {
+    while (1)
+        _hlt();
+    return 0;
+}
+
+static uint64_t stringLength(const char *string) {
+    uint64_t length = 0;
+    while (string[length])
+        length++;
+    return length;
+}
+
+/* Copies argv into a single block: the pointer array followed by the strings */
+static char **copyArguments(uint64_t argc, char *argv[]) {
+    uint64_t bytes = (argc + 1) * sizeof(char *);
+    for (uint64_t i = 0; i < argc; i++)
+        bytes += stringLength(argv[i]) + 1;
+
+    char **copy = allocMemory(bytes);
+    if (!copy)
+        return NULL;
+
+    char *strings = (char *)(copy + argc + 1);
+    for (uint64_t i = 0; i < argc; i++) {
+        uint64_t length = stringLength(argv[i]) + 1;
+        memcpy(strings, argv[i], length);
+        copy[i] = strings;
+        strings += length;
+    }
+    copy[argc] = NULL;
+    return copy;
+}
+
+static Process *spawn(pid_t pid, const char *name, ProcessEntry entry, uint64_t argc, char *argv[], pid_t ppid) {
+    uint32_t slot = 0;
+    while (slot < MAX_PROCESSES && processes[slot])
+        slot++;
+    if (slot == MAX_PROCESSES || (argc && !argv))
+        return NULL;
+
+    Process *process = kmem_cache_alloc(processCache);
+    if (!process)
+        return NULL;
+
+    process->stack = allocMemory(PROCESS_STACK_SIZE);
+    process->argv = copyArguments(argc, argv);
+    if (!process->stack || !process->argv) {
+        freeMemory(process->stack);
+        freeMemory(process->argv);
+        kmem_cache_free(processCache, process);
+        return NULL;
+    }
+
+    uint32_t i = 0;
+    for (; name && name[i] && i < PROCESS_NAME_LENGTH - 1; i++)
+        process->name[i] = name[i];
+    process->name[i] = 0;
+
+    Process *parent = ppid ? findProcess(ppid) : NULL;
+    initFileDescriptors(process->fds, parent ? parent->fds : NULL);
+
+    process->pid = pid;
+    process->ppid = ppid;
+    process->state = PROCESS_READY;
+    process->exitCode = 0;
+    process->waitingFor = 0;
+    process->blockedOn = NULL;
+    process->wakeTick = 0;
+    process->sleepIndex = -1;
+    process->priority = process->level = PRIORITY_DEFAULT;
+    process->readySince = 0;
+    process->next = process->prev = NULL;
+    process->ticks = process->dispatches = 0;
+    process->lockDepth = 0;     // its first switch in goes straight to processStart, outside the kernel
+    process->runningOn = -1;
+    process->homeCpu = -1;
+
+    // The top slot is a null return address for processStart, keeping the SysV alignment at its entry
+    uint64_t top = ((uint64_t)process->stack + PROCESS_STACK_SIZE) & ~(uint64_t)0xF;
+    top -= sizeof(uint64_t);
+    *(uint64_t *)top = 0;
+
+    InitialFrame *frame = (InitialFrame *)(top - sizeof(InitialFrame));
+    memset(frame, 0, sizeof(InitialFrame));
+    frame->rdi = (uint64_t)entry;
+    frame->rsi = argc;
+    frame->rdx = (uint64_t)process->argv;
+    frame->rip = (uint64_t)processStart;
+    frame->cs = KERNEL_CS;
+    frame->rflags = INITIAL_RFLAGS;
+    frame->rsp = top;
+    frame->ss = KERNEL_SS;
+    process->rsp = (uint64_t)frame;
+
+    processes[slot] = process;
+    return process;
+}
+
+static void release(Process *process) {
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++)
+        if (processes[i] == process)
+            processes[i] = NULL;
+
+    freeMemory(process->stack);
+    freeMemory(process->argv);
+    kmem_cache_free(processCache, process);
+}
+
+void initProcesses(void) {
+    processCache = kmem_cache_create("process", sizeof(Process), NULL);
+    idleProcess = spawn(IDLE_PID, "idle", idle, 0, NULL, 0);
+    getCpu()->idle = idleProcess;
+}
+
+Process *createIdleProcess(void) {
+    return spawn(IDLE_PID, "idle", idle, 0, NULL, 0);
+}
+
+Process *getIdleProcess(void) {
+    return getCpu()->idle;
+}
+
+pid_t createProcess(const char *name, ProcessEntry entry, uint64_t argc, char *argv[], pid_t ppid) {
+    if (!entry)
+        return -1;
+
+    Process *process = spawn(nextPid, name, entry, argc, argv, ppid);
+    if (!process)
+        return -1;
+    nextPid++;
+
+    readyProcess(process);
+    return process->pid;
+}
+
+/* Readies the parent of `zombie` if it is blocked in waitpid for it */
+static void wakeWaitingParent(Process *zombie) {
+    Process *parent = zombie->ppid ? findProcess(zombie->ppid) : NULL;
+    if (parent && parent->state == PROCESS_BLOCKED && (parent->waitingFor == zombie->pid || parent->waitingFor == -1))
+        readyProcess(parent);
+}
+
+/*
+ * Turns `process` into a zombie and notifies whoever cares about it. Returns
+ * the CPU still running it; otherwise it may already be released.
+ */
+static int8_t terminate(Process *process, int64_t exitCode) {
+    if (process->state == PROCESS_BLOCKED) {
+        waitQueueCancel(process);
+        sleepQueueCancel(process);
+    }
+
+    process->exitCode = exitCode;
+    int8_t cpu = stopProcess(process, PROCESS_ZOMBIE);
+    closeFileDescriptors(process->fds); // readers of its pipes see end of file
+    releaseRobustLocks(process->pid);   // it may have died inside malloc
+
+    // Orphans: nobody will wait for them any more
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++)
+        if (processes[i] && processes[i]->ppid == process->pid)
+            processes[i]->ppid = 0;
+
+    if (process->ppid && !findProcess(process->ppid))
+        process->ppid = 0;
+    releaseDeadProcesses();
+    return cpu;
+}
+
+void exitProcess(int64_t exitCode) {
+    _cli();
+    kernelLock();   // processStart calls it outside any syscall; it never gets to unlock
+    terminate(getCurrentProcess(), exitCode);
+    yield();
+    __builtin_unreachable();
+}
+
+int32_t killProcess(pid_t pid) {
+    Process *process = findProcess(pid);
+    if (!process || process == idleProcess || process->pid == INIT_PID || process->state == PROCESS_ZOMBIE)
+        return -1;
+
+    if (process == getCurrentProcess())
+        exitProcess(-1);
+
+    int8_t cpu = terminate(process, -1);
+    if (cpu >= 0)
+        sendReschedule(getCpuByIndex(cpu));
+    return 0;
+}
+
+void releaseDeadProcesses(void) {
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        Process *process = processes[i];
+        if (!process || process->state != PROCESS_ZOMBIE || process->runningOn >= 0)
+            continue;
+        if (process->ppid == 0)
+            release(process);
+        else
+            wakeWaitingParent(process);
+    }
+}
+
+static Process *findZombieChild(pid_t ppid, pid_t pid, uint8_t *hasChild) {
+    *hasChild = 0;
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        Process *process = processes[i];
+        if (!process || process->ppid != ppid || (pid != -1 && process->pid != pid))
+            continue;
+        *hasChild = 1;
+        // Killed while running on another CPU, it is not collectable until that CPU leaves its stack
+        if (process->state == PROCESS_ZOMBIE && process->runningOn < 0)
+            return process;
+    }
+    return NULL;
+}
+
+pid_t waitProcess(pid_t pid, int64_t *status) {
+    Process *self = getCurrentProcess();
+    uint8_t hasChild;
+    Process *child;
+
+    // Loops because an explicit unblock may wake us before the child is done
+    while (!(child = findZombieChild(self->pid, pid, &hasChild))) {
+        if (!hasChild)
+            return -1;
+        self->waitingFor = pid;
+        self->state = PROCESS_BLOCKED;
+        yield();
+    }
+    self->waitingFor = 0;
+
+    pid_t childPid = child->pid;
+    if (status)
+        *status = child->exitCode;
+    release(child);
+    return childPid;
+}
+
+int32_t blockProcess(pid_t pid) {
+    Process *process = findProcess(pid);
+    if (!process || process == idleProcess || (process->state != PROCESS_READY && process->state != PROCESS_RUNNING))
+        return -1;
+
+    int8_t cpu = stopProcess(process, PROCESS_BLOCKED);
+    if (process == getCurrentProcess())
+        yield();
+    else if (cpu >= 0)
+        sendReschedule(getCpuByIndex(cpu));
+    return 0;
+}
+
+int32_t unblockProcess(pid_t pid) {
+    Process *process = findProcess(pid);
+    if (!process || process->state != PROCESS_BLOCKED || process->blockedOn || process->sleepIndex >= 0)
+        return -1;
+
+    readyProcess(process);
+    return 0;
+}
+
+int32_t niceProcess(pid_t pid, uint8_t priority) {
+    Process *process = findProcess(pid);
+    if (!process || process == idleProcess || process->state == PROCESS_ZOMBIE || priority > PRIORITY_HIGHEST)
+        return -1;
+
+    setPriority(process, priority);
+    return 0;
+}
+
+pid_t getCurrentPid(void) {
+    Process *process = getCurrentProcess();
+    return process ? process->pid : 0;
+}
+
+uint32_t getProcesses(ProcessInfo *info, uint32_t maxEntries) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < MAX_PROCESSES && count < maxEntries; i++) {
+        Process *process = processes[i];
+        if (!process)
+            continue;
+
+        ProcessInfo *out = &info[count++];
+        out->pid = process->pid;
+        out->ppid = process->ppid;
+        memcpy(out->name, process->name, PROCESS_NAME_LENGTH);
+        out->state = process->state;
+        out->priority = process->priority;
+        out->ticks = process->ticks;
+        out->dispatches = process->dispatches;
+    }
+    return count;
+}
+
+void exitFaultingProcess(void) {
+    Process *process = getCurrentProcess();
+    if (process && process->pid != INIT_PID)
+        exitProcess(-1);
+}
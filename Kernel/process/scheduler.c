@@ -0,0 +1,415 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * Preemptive priority scheduler.
+ * _irq00Handler and _irq81Handler push the full register frame on the
+ * running process' stack and hand its stack pointer to the scheduler, which
+ * returns the stack pointer of the process to resume; the handler pops that
+ * process' frame and irets into it.
+ *
+ * Ready processes wait in one FIFO queue per level, and a bitmap of the
+ * non-empty levels makes picking the next one a single find-first-set. A
+ * process gets PRIORITY + 1 quanta per turn, so higher priorities also run
+ * longer. To keep low priorities from starving, the head of each queue (its
+ * oldest process) moves up one level once it has waited AGING_TICKS, and
+ * drops back to its own priority the next time it is queued. The idle
+ * process only runs when every queue is empty.
+ *
+ * The kernel is not preemptible: syscalls run with interrupts disabled except
+ * while they halt waiting for one. Switching does not take the kernel lock
+ * (kernelLock.h): each run queue has its own lock, so CPUs switch processes
+ * in parallel and only meet when one steals from another. A process switched
+ * out is only queued again by finishSwitch, once its CPU is off its stack;
+ * until then it still counts as running there (runningOn). State changes of
+ * processes that may be queued or running elsewhere (readyProcess,
+ * stopProcess, setPriority) take the lock of the queue they belong to. They
+ * are called with the kernel lock held, which is what keeps a blocked process
+ * from being readied twice.
+ *
+ * With a tickless timer, interrupts only come when some deadline is due, so a
+ * tick may account for several: the scheduler catches up with the timer's
+ * tick count instead of counting interrupts, and tells it when it next needs
+ * the CPU back (schedulerNextDeadline).
+ *
+ * Every CPU runs this same loop over its own run queue, with its own running
+ * process, quantum and idle process (cpu.h). A process that becomes ready
+ * goes back to the CPU it last ran on, unless that one is busy and another is
+ * idle, in which case the idle one gets it through a reschedule IPI. A CPU
+ * about to go idle steals from the busiest other queue instead, and one that
+ * leaves processes waiting behind it kicks an idle CPU to come and steal
+ * them. A process blocked or killed from another CPU is still on its CPU
+ * until that CPU takes the IPI, and must not be picked again before it
+ * leaves: readying it just lets it keep running.
+ */
+
+#include <scheduler.h>
+#include <interrupts.h>
+#include <kernelLock.h>
+#include <cpu.h>
+#include <stddef.h>
+
+static uint64_t contextSwitches = 0;
+static uint8_t started = 0;
+
+#define LEVEL_BIT(level) (1u << (PRIORITY_HIGHEST - (level)))
+
+static RunQueue *queueOf(Process *process) {
+    return &getCpuByIndex(process->homeCpu)->runQueue;
+}
+
+/*
+ * Locks the queue `process` belongs to, or returns NULL if it never had one.
+ * A steal moves it to another queue holding both locks, so the home read
+ * before locking is only good if it is still the same after.
+ */
+static RunQueue *lockQueue(Process *process) {
+    while (1) {
+        int8_t home = __atomic_load_n(&process->homeCpu, __ATOMIC_ACQUIRE);
+        if (home < 0)
+            return NULL;
+        RunQueue *queue = &getCpuByIndex(home)->runQueue;
+        spinLock(&queue->lock);
+        if (process->homeCpu == home)
+            return queue;
+        spinUnlock(&queue->lock);
+    }
+}
+
+static void unlockQueue(RunQueue *queue) {
+    if (queue)
+        spinUnlock(&queue->lock);
+}
+
+static void enqueue(Process *process, uint8_t level) {
+    RunQueue *queue = queueOf(process);
+    process->level = level;
+    process->next = NULL;
+    process->prev = queue->tail[level];
+    if (queue->tail[level]) queue->tail[level]->next = process;
+    else                    queue->head[level] = process;
+    queue->tail[level] = process;
+    queue->levels |= LEVEL_BIT(level);
+    if (++queue->length > queue->maxLength)
+        queue->maxLength = queue->length;
+}
+
+static void dequeue(Process *process) {
+    RunQueue *queue = queueOf(process);
+    uint8_t level = process->level;
+    if (process->prev) process->prev->next = process->next;
+    else               queue->head[level] = process->next;
+    if (process->next) process->next->prev = process->prev;
+    else               queue->tail[level] = process->prev;
+    process->next = process->prev = NULL;
+    if (!queue->head[level])
+        queue->levels &= ~LEVEL_BIT(level);
+    queue->length--;
+}
+
+static uint8_t topLevel(RunQueue *queue) {
+    return PRIORITY_HIGHEST - __builtin_ctz(queue->levels);
+}
+
+static Process *firstReady(RunQueue *queue) {
+    return queue->head[topLevel(queue)];
+}
+
+static void makeReady(Process *process) {
+    process->state = PROCESS_READY;
+    process->readySince = getTicks();
+    enqueue(process, process->priority);
+    queueOf(process)->enqueued++;
+}
+
+/* Makes `process` the one `cpu` runs. Under the lock of the queue it came from, if any */
+static void dispatch(Process *process, Cpu *cpu) {
+    process->state = PROCESS_RUNNING;
+    process->runningOn = cpu->index;
+    process->homeCpu = cpu->index;
+}
+
+static uint8_t isIdle(Cpu *cpu) {
+    return cpu->online && cpu->current == cpu->idle && cpu->runQueue.length == 0;
+}
+
+static Cpu *findIdleCpu(void) {
+    for (uint8_t i = 0; i < getCpuCount(); i++) {
+        Cpu *cpu = getCpuByIndex(i);
+        if (isIdle(cpu))
+            return cpu;
+    }
+    return NULL;
+}
+
+/* Counts the running process too, so a busy CPU with an empty queue is not taken for an idle one */
+static Cpu *leastLoadedCpu(void) {
+    Cpu *best = NULL;
+    uint32_t bestLoad = UINT32_MAX;
+    for (uint8_t i = 0; i < getCpuCount(); i++) {
+        Cpu *cpu = getCpuByIndex(i);
+        uint32_t load = cpu->runQueue.length + (cpu->current != NULL && cpu->current != cpu->idle);
+        if (load < bestLoad) {
+            best = cpu;
+            bestLoad = load;
+        }
+    }
+    return best;
+}
+
+/* The CPU it last ran on may still have it in cache, but an idle one gets it running now */
+static Cpu *placeProcess(Process *process) {
+    Cpu *home = process->homeCpu >= 0 ? getCpuByIndex(process->homeCpu) : NULL;
+    if (home && isIdle(home))
+        return home;
+    Cpu *idle = findIdleCpu();
+    if (idle)
+        return idle;
+    return home ? home : leastLoadedCpu();
+}
+
+/* Lets work waiting in `cpu`'s queue go to a CPU with nothing to do */
+static void offerWork(Cpu *cpu) {
+    if (cpu->runQueue.length) {
+        Cpu *idle = findIdleCpu();
+        if (idle)
+            sendReschedule(idle);
+    }
+}
+
+void readyProcess(Process *process) {
+    // Still on its CPU, which queues it again once it is off its stack (finishSwitch)
+    RunQueue *queue = lockQueue(process);
+    if (process->runningOn >= 0) {
+        process->state = PROCESS_RUNNING;
+        unlockQueue(queue);
+        return;
+    }
+    unlockQueue(queue);
+
+    // Neither queued nor running, nobody else can reach it until it is queued
+    Cpu *cpu = placeProcess(process);
+    spinLock(&cpu->runQueue.lock);
+    process->homeCpu = cpu->index;
+    makeReady(process);
+    uint8_t first = cpu->runQueue.length == 1;
+    spinUnlock(&cpu->runQueue.lock);
+
+    // Its CPU was idle, or had no reason to preempt anything until now
+    if (first)
+        sendReschedule(cpu);
+}
+
+int8_t stopProcess(Process *process, ProcessState state) {
+    RunQueue *queue = lockQueue(process);
+    if (process->state == PROCESS_READY)
+        dequeue(process);
+    process->state = state;
+    int8_t cpu = process->runningOn;
+    unlockQueue(queue);
+    return cpu;
+}
+
+void setPriority(Process *process, uint8_t priority) {
+    RunQueue *queue = lockQueue(process);
+    process->priority = priority;
+    if (process->state == PROCESS_READY && process->level < priority) {
+        dequeue(process);
+        enqueue(process, priority);
+    }
+    unlockQueue(queue);
+}
+
+/* Queue heads are the oldest entries of their level, so checking them is enough */
+static void age(RunQueue *queue) {
+    uint64_t now = getTicks();
+    for (uint8_t level = PRIORITY_LOWEST; level < PRIORITY_HIGHEST; level++) {
+        Process *oldest = queue->head[level];
+        if (oldest && now - oldest->readySince >= AGING_TICKS) {
+            dequeue(oldest);
+            oldest->readySince = now;
+            enqueue(oldest, level + 1);
+        }
+    }
+}
+
+static Cpu *busiestPeer(Cpu *self) {
+    Cpu *busiest = NULL;
+    for (uint8_t i = 0; i < getCpuCount(); i++) {
+        Cpu *cpu = getCpuByIndex(i);
+        if (cpu != self && cpu->runQueue.length > (busiest ? busiest->runQueue.length : 0))
+            busiest = cpu;
+    }
+    return busiest;
+}
+
+/*
+ * Takes the next process of the busiest other queue for an idle CPU. That is
+ * the one that has waited the longest at the top level, so it is also the
+ * one least likely to still be in its old CPU's cache. Both queues are locked
+ * in CPU order, so two CPUs stealing from each other cannot deadlock.
+ */
+static Process *steal(Cpu *thief) {
+    Cpu *victim = busiestPeer(thief);
+    if (!victim)
+        return NULL;
+
+    Cpu *first = thief->index < victim->index ? thief : victim;
+    Cpu *second = first == thief ? victim : thief;
+    spinLock(&first->runQueue.lock);
+    spinLock(&second->runQueue.lock);
+
+    // busiestPeer looked without the lock, it may have emptied since
+    Process *process = NULL;
+    if (victim->runQueue.length) {
+        process = firstReady(&victim->runQueue);
+        dequeue(process);
+        dispatch(process, thief);
+        victim->runQueue.stolen++;
+        thief->runQueue.steals++;
+    }
+
+    spinUnlock(&second->runQueue.lock);
+    spinUnlock(&first->runQueue.lock);
+    return process;
+}
+
+/* Charges the ticks since the last call to whatever `cpu` is running, and returns them */
+static uint64_t account(Cpu *cpu) {
+    uint64_t tick = getTicks();
+    uint64_t elapsed = tick - cpu->lastTick;
+    cpu->lastTick = tick;
+
+    if (cpu->current) {
+        cpu->current->ticks += elapsed;
+        if (cpu->current == cpu->idle) cpu->idleTicks += elapsed;
+        else                           cpu->busyTicks += elapsed;
+    }
+    return elapsed;
+}
+
+Process *getCurrentProcess(void) {
+    return getCpu()->current;
+}
+
+uint64_t getContextSwitches(void) {
+    return __atomic_load_n(&contextSwitches, __ATOMIC_RELAXED);
+}
+
+uint64_t schedule(uint64_t rsp) {
+    if (!started)
+        return rsp;
+
+    Cpu *cpu = getCpu();
+    Process *current = cpu->current;
+    cpu->reschedulePending = 0;
+    account(cpu);
+
+    if (current) {
+        current->rsp = rsp;
+        current->lockDepth = cpu->lockDepth;
+    }
+
+    RunQueue *queue = &cpu->runQueue;
+    spinLock(&queue->lock);
+    age(queue);
+
+    // `current` is not queued again until finishSwitch; picking it here is what requeuing it at its priority would do
+    uint8_t runnable = current && current != cpu->idle && current->state == PROCESS_RUNNING;
+    Process *next = NULL;
+    if (queue->length && (!runnable || current->priority <= topLevel(queue))) {
+        next = firstReady(queue);
+        dequeue(next);
+        dispatch(next, cpu);
+    } else if (runnable) {
+        next = current;
+    }
+    spinUnlock(&queue->lock);
+
+    if (!next)
+        next = steal(cpu);
+    if (!next) {
+        next = cpu->idle;
+        dispatch(next, cpu);
+    }
+
+    if (next != current) {
+        __atomic_fetch_add(&contextSwitches, 1, __ATOMIC_RELAXED);
+        cpu->previous = current;
+    }
+    next->dispatches++;
+    cpu->current = next;
+    cpu->dispatches++;
+    cpu->quantumLeft = SCHEDULER_QUANTUM * (next->priority + 1);
+
+    // `current` keeps its depth of the kernel lock in its PCB; `next` gets back its own
+    kernelLockSwitch(next->lockDepth);
+
+    offerWork(cpu);
+    return next->rsp;
+}
+
+void finishSwitch(void) {
+    Cpu *cpu = getCpu();
+    Process *previous = cpu->previous;
+    if (!previous)
+        return;
+    cpu->previous = NULL;
+
+    RunQueue *queue = &cpu->runQueue;
+    spinLock(&queue->lock);
+    previous->runningOn = -1;
+    if (previous->state == PROCESS_RUNNING && previous != cpu->idle)
+        makeReady(previous);
+    uint8_t dead = previous->state == PROCESS_ZOMBIE;
+    spinUnlock(&queue->lock);
+
+    // From here on another CPU may run it, or its parent collect it
+    if (dead) {
+        kernelLock();
+        releaseDeadProcesses();
+        kernelUnlock();
+    }
+    offerWork(cpu);
+}
+
+uint64_t schedulerTick(uint64_t rsp) {
+    Cpu *cpu = getCpu();
+    Process *current = cpu->current;
+    if (!started || !current)
+        return rsp;
+
+    cpu->reschedulePending = 0;
+    uint64_t elapsed = account(cpu);
+
+    // The idle process gives way as soon as there is something to run
+    if (current == cpu->idle)
+        return cpu->runQueue.length || busiestPeer(cpu) ? schedule(rsp) : rsp;
+
+    // Blocked or killed from another CPU
+    if (current->state != PROCESS_RUNNING)
+        return schedule(rsp);
+
+    if (cpu->quantumLeft > elapsed) {
+        cpu->quantumLeft -= elapsed;
+        return rsp;
+    }
+    return schedule(rsp);
+}
+
+uint64_t schedulerNextDeadline(void) {
+    Cpu *cpu = getCpu();
+    if (!started || !cpu->current || !cpu->runQueue.length)
+        return UINT64_MAX;  // nobody is waiting for the CPU
+    return cpu->current == cpu->idle ? cpu->lastTick : cpu->lastTick + cpu->quantumLeft;
+}
+
+void yield(void) {
+    _yield();
+}
+
+void startScheduler(void) {
+    started = 1;
+    _yield();
+    __builtin_unreachable();
+}
@@ -0,0 +1,37 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <kernelLock.h>
+#include <spinlock.h>
+#include <cpu.h>
+
+static Spinlock bigKernelLock = NAMED_SPINLOCK_INIT("kernel");
+
+void kernelLock(void) {
+    Cpu *cpu = getCpu();
+    if (cpu->lockDepth++ == 0)
+        spinLock(&bigKernelLock);
+}
+
+void kernelUnlock(void) {
+    Cpu *cpu = getCpu();
+    if (--cpu->lockDepth == 0)
+        spinUnlock(&bigKernelLock);
+}
+
+void kernelLockSwitch(uint32_t depth) {
+    Cpu *cpu = getCpu();
+    if (depth && !cpu->lockDepth)
+        spinLock(&bigKernelLock);
+    else if (!depth && cpu->lockDepth)
+        spinUnlock(&bigKernelLock);
+    cpu->lockDepth = depth;
+}
+
+void kernelUnlockAll(void) {
+    Cpu *cpu = getCpu();
+    if (cpu->lockDepth) {
+        cpu->lockDepth = 0;
+        spinUnlock(&bigKernelLock);
+    }
+}
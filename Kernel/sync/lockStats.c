@@ -0,0 +1,38 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <spinlock.h>
+
+static LockStats *volatile locks[MAX_LOCKS];
+static uint32_t lockCount = 0;
+
+void lockStatsRegister(LockStats *stats) {
+    // Readers of a reader-writer lock may get here together
+    if (__atomic_exchange_n(&stats->registered, 1, __ATOMIC_RELAXED))
+        return;
+
+    uint32_t slot = __atomic_fetch_add(&lockCount, 1, __ATOMIC_RELAXED);
+    if (slot < MAX_LOCKS)
+        __atomic_store_n(&locks[slot], stats, __ATOMIC_RELEASE);
+}
+
+uint32_t getLockStats(LockInfo *info, uint32_t maxEntries) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < lockCount && i < MAX_LOCKS && count < maxEntries; i++) {
+        LockStats *stats = __atomic_load_n(&locks[i], __ATOMIC_ACQUIRE);
+        if (stats == NULL)
+            continue;   // slot taken, not filled in yet
+
+        LockInfo *out = &info[count++];
+        uint32_t j = 0;
+        for (; stats->name[j] && j < LOCK_NAME_LENGTH - 1; j++)
+            out->name[j] = stats->name[j];
+        out->name[j] = 0;
+        out->kind = stats->kind;
+        out->acquisitions = stats->acquisitions;
+        out->contended = stats->contended;
+        out->contentionSpins = stats->contentionSpins;
+        out->maxHoldCycles = stats->maxHoldCycles;
+    }
+    return count;
+}
@@ -0,0 +1,38 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <robustLock.h>
+#include <spinlock.h>
+#include <stddef.h>
+
+static volatile pid_t *locks[MAX_ROBUST_LOCKS];
+static uint32_t lockCount = 0;
+static Spinlock registryLock = NAMED_SPINLOCK_INIT("robust");
+
+int32_t registerRobustLock(volatile pid_t *lock) {
+    if (lock == NULL)
+        return -1;
+
+    int32_t result = 0;
+    spinLock(&registryLock);
+    uint32_t i = 0;
+    while (i < lockCount && locks[i] != lock)
+        i++;
+    if (i == lockCount) {
+        if (lockCount < MAX_ROBUST_LOCKS)
+            locks[lockCount++] = lock;
+        else
+            result = -1;
+    }
+    spinUnlock(&registryLock);
+    return result;
+}
+
+void releaseRobustLocks(pid_t pid) {
+    spinLock(&registryLock);
+    for (uint32_t i = 0; i < lockCount; i++) {
+        pid_t holder = pid;     // only if it is still the one holding it
+        __atomic_compare_exchange_n(locks[i], &holder, 0, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+    }
+    spinUnlock(&registryLock);
+}
@@ -0,0 +1,196 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * Named counting semaphores.
+ * Names are looked up through a chained hash table only when opening; the
+ * returned id indexes a table, so wait and post never search.
+ *
+ * Wait first tries to take a unit with a compare-and-swap on the value, with
+ * no lock at all. Only when the value is 0 does it take the semaphore's lock,
+ * try once more, and otherwise queue the caller and block it. Post hands its
+ * unit straight to the oldest waiter instead of incrementing, so a woken
+ * process never has to compete for it again; it only increments (lock xadd)
+ * when the queue is empty. Both slow paths run under the lock, which keeps a
+ * post from slipping in between a waiter's last check and its enqueue.
+ *
+ * A killed waiter is dropped from the queue by waitQueueCancel.
+ *
+ * A semaphore closed while processes still wait on it lives on with no
+ * references. semPost destroys it when it wakes the last of them; one whose
+ * last waiter was killed instead is reclaimed by the next semOpen that comes
+ * across it, by name or by slot.
+ */
+
+#include <semaphore.h>
+#include <scheduler.h>
+#include <spinlock.h>
+#include <waitQueue.h>
+#include <slab.h>
+#include <stddef.h>
+
+#define HASH_BUCKETS 32
+
+struct Semaphore {
+    char             name[SEM_NAME_LENGTH];
+    volatile int64_t value;
+    uint32_t         refs;
+    sem_t            id;
+    Spinlock         lock;          // guards the wait queue and the slow paths
+    WaitQueue        waiters;
+    struct Semaphore *hashNext;
+};
+
+static KmemCache *semaphoreCache = NULL;
+static Semaphore *buckets[HASH_BUCKETS];
+static Semaphore *semaphores[MAX_SEMAPHORES];
+static Spinlock tableLock = NAMED_SPINLOCK_INIT("semaphores");  // guards buckets and semaphores
+
+/* djb2 */
+static uint32_t hash(const char *name) {
+    uint32_t h = 5381;
+    for (uint32_t i = 0; name[i] && i < SEM_NAME_LENGTH - 1; i++)
+        h = h * 33 + (uint8_t)name[i];
+    return h % HASH_BUCKETS;
+}
+
+static int32_t sameName(const char *a, const char *b) {
+    uint32_t i = 0;
+    for (; i < SEM_NAME_LENGTH - 1 && a[i] && a[i] == b[i]; i++)
+        ;
+    return i == SEM_NAME_LENGTH - 1 || a[i] == b[i];
+}
+
+static Semaphore *getSemaphore(sem_t id) {
+    return (id >= 0 && id < MAX_SEMAPHORES) ? semaphores[id] : NULL;
+}
+
+// No references and nobody waiting: nothing can reach it but a new semOpen
+static int32_t isOrphan(Semaphore *sem) {
+    return sem->refs == 0 && !sem->waiters.head;
+}
+
+// Called with tableLock held
+static void destroy(Semaphore *sem) {
+    Semaphore **link = &buckets[hash(sem->name)];
+    while (*link != sem)
+        link = &(*link)->hashNext;
+    *link = sem->hashNext;
+    semaphores[sem->id] = NULL;
+    kmem_cache_free(semaphoreCache, sem);
+}
+
+void initSemaphores(void) {
+    semaphoreCache = kmem_cache_create("semaphore", sizeof(Semaphore), NULL);
+}
+
+sem_t semOpen(const char *name, uint32_t initialValue) {
+    if (!name || !name[0])
+        return -1;
+
+    uint32_t bucket = hash(name);
+    sem_t id = -1;
+    spinLock(&tableLock);
+
+    Semaphore *sem = buckets[bucket];
+    while (sem && !sameName(sem->name, name))
+        sem = sem->hashNext;
+    if (sem && isOrphan(sem)) {
+        destroy(sem);   // opened again from scratch, with `initialValue`
+        sem = NULL;
+    }
+
+    if (sem) {
+        sem->refs++;
+        id = sem->id;
+    } else {
+        sem_t slot = 0;
+        while (slot < MAX_SEMAPHORES && semaphores[slot] && !isOrphan(semaphores[slot]))
+            slot++;
+        if (slot < MAX_SEMAPHORES && semaphores[slot])
+            destroy(semaphores[slot]);
+        if (slot < MAX_SEMAPHORES && (sem = kmem_cache_alloc(semaphoreCache))) {
+            uint32_t i = 0;
+            for (; name[i] && i < SEM_NAME_LENGTH - 1; i++)
+                sem->name[i] = name[i];
+            sem->name[i] = 0;
+            sem->value = initialValue;
+            sem->refs = 1;
+            sem->id = id = slot;
+            sem->lock = (Spinlock) SPINLOCK_INIT;
+            sem->waiters.head = sem->waiters.tail = NULL;
+            sem->hashNext = buckets[bucket];
+            buckets[bucket] = sem;
+            semaphores[slot] = sem;
+        }
+    }
+
+    spinUnlock(&tableLock);
+    return id;
+}
+
+int32_t semClose(sem_t id) {
+    spinLock(&tableLock);
+    Semaphore *sem = getSemaphore(id);
+    if (!sem || sem->refs == 0) {   // closed more times than it was opened
+        spinUnlock(&tableLock);
+        return -1;
+    }
+
+    // Kept while anybody still waits on it, even if it forgot to open it
+    if (--sem->refs == 0 && !sem->waiters.head)
+        destroy(sem);
+
+    spinUnlock(&tableLock);
+    return 0;
+}
+
+static int32_t tryDecrement(Semaphore *sem) {
+    int64_t value = sem->value;
+    while (value > 0)
+        if (__atomic_compare_exchange_n(&sem->value, &value, value - 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            return 1;
+    return 0;
+}
+
+int32_t semWait(sem_t id) {
+    Semaphore *sem = getSemaphore(id);
+    if (!sem)
+        return -1;
+
+    if (tryDecrement(sem))
+        return 0;
+
+    spinLock(&sem->lock);
+    if (tryDecrement(sem)) {
+        spinUnlock(&sem->lock);
+        return 0;
+    }
+
+    waitQueueAdd(&sem->waiters, getCurrentProcess());
+    spinUnlock(&sem->lock);
+
+    // Resumed by semPost, which already gave us its unit
+    yield();
+    return 0;
+}
+
+int32_t semPost(sem_t id) {
+    Semaphore *sem = getSemaphore(id);
+    if (!sem)
+        return -1;
+
+    spinLock(&sem->lock);
+    if (!waitQueueWakeOne(&sem->waiters))
+        __atomic_fetch_add(&sem->value, 1, __ATOMIC_RELEASE);
+    spinUnlock(&sem->lock);
+
+    // The last waiter of an already closed semaphore just left
+    if (sem->refs == 0) {
+        spinLock(&tableLock);
+        if (getSemaphore(id) == sem && isOrphan(sem))
+            destroy(sem);
+        spinUnlock(&tableLock);
+    }
+    return 0;
+}
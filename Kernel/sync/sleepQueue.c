@@ -0,0 +1,82 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <sleepQueue.h>
+#include <scheduler.h>
+#include <stddef.h>
+
+/* Binary min-heap on wakeTick; every process knows its own slot (sleepIndex) so it can be removed when killed */
+static Process *heap[MAX_PROCESSES];
+static uint32_t size = 0;
+
+static void place(Process *process, uint32_t index) {
+    heap[index] = process;
+    process->sleepIndex = index;
+}
+
+static void siftUp(uint32_t index) {
+    Process *process = heap[index];
+    while (index > 0) {
+        uint32_t parent = (index - 1) / 2;
+        if (heap[parent]->wakeTick <= process->wakeTick)
+            break;
+        place(heap[parent], index);
+        index = parent;
+    }
+    place(process, index);
+}
+
+static void siftDown(uint32_t index) {
+    Process *process = heap[index];
+    while (1) {
+        uint32_t child = 2 * index + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && heap[child + 1]->wakeTick < heap[child]->wakeTick)
+            child++;
+        if (process->wakeTick <= heap[child]->wakeTick)
+            break;
+        place(heap[child], index);
+        index = child;
+    }
+    place(process, index);
+}
+
+static void removeAt(uint32_t index) {
+    Process *removed = heap[index];
+    removed->sleepIndex = -1;
+
+    if (index == --size)
+        return;
+
+    // The last sleeper takes the hole, then moves whichever way its deadline says
+    place(heap[size], index);
+    if (index > 0 && heap[(index - 1) / 2]->wakeTick > heap[index]->wakeTick)
+        siftUp(index);
+    else
+        siftDown(index);
+}
+
+void sleepQueueAdd(Process *process, uint64_t wakeTick) {
+    process->state = PROCESS_BLOCKED;
+    process->wakeTick = wakeTick;
+    place(process, size++);     // never full: a process sleeps at most once
+    siftUp(process->sleepIndex);
+}
+
+void sleepQueueWake(uint64_t now) {
+    while (size > 0 && heap[0]->wakeTick <= now) {
+        Process *process = heap[0];
+        removeAt(0);
+        readyProcess(process);
+    }
+}
+
+uint64_t sleepQueueNextWake(void) {
+    return size > 0 ? heap[0]->wakeTick : UINT64_MAX;
+}
+
+void sleepQueueCancel(Process *process) {
+    if (process->sleepIndex >= 0)
+        removeAt(process->sleepIndex);
+}
@@ -0,0 +1,44 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <waitQueue.h>
+#include <scheduler.h>
+#include <stddef.h>
+
+void waitQueueAdd(WaitQueue *queue, Process *process) {
+    process->state = PROCESS_BLOCKED;
+    process->blockedOn = queue;
+    process->next = NULL;
+    process->prev = queue->tail;
+    if (queue->tail) queue->tail->next = process;
+    else             queue->head = process;
+    queue->tail = process;
+}
+
+static void unlink(WaitQueue *queue, Process *process) {
+    if (process->prev) process->prev->next = process->next;
+    else               queue->head = process->next;
+    if (process->next) process->next->prev = process->prev;
+    else               queue->tail = process->prev;
+    process->next = process->prev = NULL;
+    process->blockedOn = NULL;
+}
+
+Process *waitQueueWakeOne(WaitQueue *queue) {
+    Process *process = queue->head;
+    if (process) {
+        unlink(queue, process);
+        readyProcess(process);
+    }
+    return process;
+}
+
+void waitQueueWakeAll(WaitQueue *queue) {
+    while (waitQueueWakeOne(queue))
+        ;
+}
+
+void waitQueueCancel(Process *process) {
+    if (process->blockedOn)
+        unlink(process->blockedOn, process);
+}
@@ -0,0 +1,16 @@
+#ifndef _CLOCK_H_
+#define _CLOCK_H_
+
+#include <stdint.h>
+
+#define NANOSECONDS_PER_SECOND 1000000000ULL
+
+// Clocks accepted by clock_gettime
+#define CLOCK_MONOTONIC 0   // time since boot, never goes back
+
+typedef struct {
+    int64_t seconds;
+    int64_t nanoseconds;    // 0 to NANOSECONDS_PER_SECOND - 1
+} Timespec;
+
+#endif
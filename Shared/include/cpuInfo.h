@@ -0,0 +1,22 @@
+#ifndef _CPU_INFO_H_
+#define _CPU_INFO_H_
+
+#include <stdint.h>
+
+#define MAX_CPUS 16
+
+// One entry per online CPU, as reported by get_cpu_stats
+typedef struct {
+    uint8_t  apicId;
+    int32_t  pid;           // process it is running, 0 while idle
+    uint64_t busyTicks;     // timer ticks spent running processes other than its idle one
+    uint64_t idleTicks;
+    uint64_t dispatches;    // times it switched a process in
+    uint32_t queued;        // ready processes waiting in its run queue
+    uint32_t maxQueued;
+    uint64_t enqueued;      // times a process was queued on it
+    uint64_t steals;        // processes it took from other CPUs' queues while idle
+    uint64_t stolen;        // processes other CPUs took from its queue
+} CpuInfo;
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef _INTERRUPT_STATS_H_
+#define _INTERRUPT_STATS_H_
+
+#include <stdint.h>
+
+// Interrupt counters since boot, as reported by get_interrupt_stats
+typedef struct {
+    uint64_t timer;         // PIT ticks, or local APIC one-shots in tickless mode
+    uint64_t keyboard;
+    uint64_t ticks;         // timer ticks accounted, TIMER_FREQUENCY per second either way
+    uint8_t  tickless;
+    int16_t  keyboardCpu;   // APIC ID the keyboard IRQ is delivered to, -1 under the 8259
+} InterruptStats;
+
+#endif
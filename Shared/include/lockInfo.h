@@ -0,0 +1,24 @@
+#ifndef _LOCK_INFO_H_
+#define _LOCK_INFO_H_
+
+#include <stdint.h>
+
+#define MAX_LOCKS           32
+#define LOCK_NAME_LENGTH    16
+
+typedef enum {
+    LOCK_SPIN = 0,  // ticket spinlock
+    LOCK_RW,        // reader-writer lock
+} LockKind;
+
+// One entry per named kernel lock that has been taken at least once, as reported by get_lock_stats
+typedef struct {
+    char     name[LOCK_NAME_LENGTH];
+    uint8_t  kind;              // LockKind
+    uint64_t acquisitions;
+    uint64_t contended;         // acquisitions that found it taken
+    uint64_t contentionSpins;   // iterations spent waiting for it
+    uint64_t maxHoldCycles;     // longest exclusive hold, in TSC cycles
+} LockInfo;
+
+#endif
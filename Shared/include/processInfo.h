@@ -0,0 +1,38 @@
+#ifndef _PROCESS_INFO_H_
+#define _PROCESS_INFO_H_
+
+#include <stdint.h>
+
+#define PROCESS_NAME_LENGTH 32
+#define MAX_PROCESSES 64
+
+typedef int32_t pid_t;
+
+// Higher runs first; a process runs PRIORITY + 1 quanta each time it is picked
+#define PRIORITY_LEVELS   5
+#define PRIORITY_LOWEST   0
+#define PRIORITY_DEFAULT  2
+#define PRIORITY_HIGHEST  (PRIORITY_LEVELS - 1)
+
+typedef enum {
+    PROCESS_READY = 0,
+    PROCESS_RUNNING,
+    PROCESS_BLOCKED,
+    PROCESS_ZOMBIE,     // exited, waiting for its parent to collect the exit code
+} ProcessState;
+
+// Process entry point: the process exits with its return value
+typedef int64_t (*ProcessEntry)(uint64_t argc, char *argv[]);
+
+// One entry per live process, as reported by get_processes
+typedef struct {
+    pid_t        pid;
+    pid_t        ppid;          // 0 when started by the kernel
+    char         name[PROCESS_NAME_LENGTH];
+    ProcessState state;
+    uint8_t      priority;
+    uint64_t     ticks;         // timer ticks spent running
+    uint64_t     dispatches;    // times it was switched in
+} ProcessInfo;
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef _SYSCALL_TABLE_H_
+#define _SYSCALL_TABLE_H_
+
+#include <stdint.h>
+
+/*
+ * Syscall ABI shared by the Kernel and Userland.
+ * Numbers are dense indices into the kernel's dispatch table, so they must
+ * stay consecutive from 0. Bump SYSCALL_ABI_VERSION whenever an entry is
+ * renumbered, removed, or changes its arguments; appending keeps the ABI.
+ *
+ * SYSCALL(number, name, argc, flags): the kernel handler is sys_<name>,
+ * and Userland calls it through SYS_<name>.
+ */
+#define SYSCALL_ABI_VERSION 2
+
+#define SYSCALL_BLOCKING    0x01    // may wait for interrupts (its cycles include the wait)
+
+#define SYSCALL_LIST(SYSCALL) \
+    SYSCALL(0,  abi_version,                   0, 0) \
+    SYSCALL(1,  read,                          3, SYSCALL_BLOCKING) \
+    SYSCALL(2,  write,                         3, SYSCALL_BLOCKING) \
+    SYSCALL(3,  start_beep,                    1, 0) \
+    SYSCALL(4,  stop_beep,                     0, 0) \
+    SYSCALL(5,  fonts_text_color,              1, 0) \
+    SYSCALL(6,  fonts_background_color,        1, 0) \
+    SYSCALL(7,  fonts_decrease_size,           0, 0) \
+    SYSCALL(8,  fonts_increase_size,           0, 0) \
+    SYSCALL(9,  fonts_set_size,                1, 0) \
+    SYSCALL(10, clear_screen,                  0, 0) \
+    SYSCALL(11, clear_input_buffer,            0, 0) \
+    SYSCALL(12, hour,                          1, 0) \
+    SYSCALL(13, minute,                        1, 0) \
+    SYSCALL(14, second,                        1, 0) \
+    SYSCALL(15, circle,                        4, 0) \
+    SYSCALL(16, rectangle,                     5, 0) \
+    SYSCALL(17, fill_video_memory,             1, 0) \
+    SYSCALL(18, exec,                          1, SYSCALL_BLOCKING) \
+    SYSCALL(19, register_key,                  2, 0) \
+    SYSCALL(20, window_width,                  0, 0) \
+    SYSCALL(21, window_height,                 0, 0) \
+    SYSCALL(22, sleep_milis,                   1, SYSCALL_BLOCKING) \
+    SYSCALL(23, get_register_snapshot,         1, 0) \
+    SYSCALL(24, get_character_without_display, 0, SYSCALL_BLOCKING) \
+    SYSCALL(25, null,                          0, 0) \
+    SYSCALL(26, get_mem_status,                1, 0) \
+    SYSCALL(27, malloc,                        1, 0) \
+    SYSCALL(28, free,                          1, 0) \
+    SYSCALL(29, realloc,                       2, 0) \
+    SYSCALL(30, calloc,                        2, 0) \
+    SYSCALL(31, get_syscall_stats,             2, 0) \
+    SYSCALL(32, create_process,                4, 0) \
+    SYSCALL(33, getpid,                        0, 0) \
+    SYSCALL(34, yield,                         0, 0) \
+    SYSCALL(35, kill,                          1, 0) \
+    SYSCALL(36, waitpid,                       2, SYSCALL_BLOCKING) \
+    SYSCALL(37, block,                         1, 0) \
+    SYSCALL(38, unblock,                       1, 0) \
+    SYSCALL(39, get_processes,                 2, 0) \
+    SYSCALL(40, exit,                          1, 0) \
+    SYSCALL(41, nice,                          2, 0) \
+    SYSCALL(42, sem_open,                      2, 0) \
+    SYSCALL(43, sem_wait,                      1, SYSCALL_BLOCKING) \
+    SYSCALL(44, sem_post,                      1, 0) \
+    SYSCALL(45, sem_close,                     1, 0) \
+    SYSCALL(46, context_switches,              0, 0) \
+    SYSCALL(47, pipe,                          1, 0) \
+    SYSCALL(48, close,                         1, 0) \
+    SYSCALL(49, dup,                           1, 0) \
+    SYSCALL(50, dup2,                          2, 0) \
+    SYSCALL(51, open,                          1, 0) \
+    SYSCALL(52, clock_gettime,                 2, 0) \
+    SYSCALL(53, get_interrupt_stats,           1, 0) \
+    SYSCALL(54, set_irq_affinity,              2, 0) \
+    SYSCALL(55, get_cpu_stats,                 2, 0) \
+    SYSCALL(56, get_lock_stats,                2, 0) \
+    SYSCALL(57, flush_video,                   0, 0) \
+    SYSCALL(58, register_robust_lock,          1, 0)
+
+#define SYSCALL_NUMBER(number, name, argc, flags) SYS_##name = number,
+#define SYSCALL_ONE(number, name, argc, flags) + 1
+
+enum {
+    SYSCALL_LIST(SYSCALL_NUMBER)
+    SYSCALL_COUNT = 0 SYSCALL_LIST(SYSCALL_ONE)
+};
+
+#define SYSCALL_NAME_LENGTH 32
+
+// One entry per syscall, as reported by get_syscall_stats
+typedef struct {
+    char     name[SYSCALL_NAME_LENGTH];
+    uint32_t number;
+    uint8_t  argc;
+    uint8_t  flags;
+    uint64_t calls;
+    uint64_t cycles;    // cumulative TSC cycles spent inside the handler
+} SyscallStats;
+
+#endif
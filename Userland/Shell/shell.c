@@ -6,57 +6,13 @@
 #include <sys.h>
 #include <exceptions.h>
 
-#ifdef ANSI_4_BIT_COLOR_SUPPORT
-    #include <ansiColors.h>
-#endif
+#include <test_util.h>
 
-// Test utility functions from test_util.c
-static uint32_t m_z = 362436069;
-static uint32_t m_w = 521288629;
-
-uint32_t GetUint() {
-  m_z = 36969 * (m_z & 65535) + (m_z >> 16);
-  m_w = 18000 * (m_w & 65535) + (m_w >> 16);
-  return (m_z << 16) + m_w;
-}
-
-uint32_t GetUniform(uint32_t max) {
-  uint32_t u = GetUint();
-  return (u + 1.0) * 2.328306435454494e-10 * max;
-}
-
-uint8_t memcheck(void *start, uint8_t value, uint32_t size) {
-  uint8_t *p = (uint8_t *)start;
-  uint32_t i;
-
-  for (i = 0; i < size; i++, p++)
-    if (*p != value)
-      return 0;
-
-  return 1;
-}
-
-int64_t satoi(char *str) {
-  uint64_t i = 0;
-  int64_t res = 0;
-  int8_t sign = 1;
-
-  if (!str)
-    return 0;
-
-  if (str[i] == '-') {
-    i++;
-    sign = -1;
-  }
-
-  for (; str[i] != '\0'; ++i) {
-    if (str[i] < '0' || str[i] > '9')
-      return 0;
-    res = res * 10 + str[i] - '0';
-  }
-
-  return res * sign;
-}
+// Shared test suite (Userland/tests)
+int64_t test_processes(uint64_t argc, char *argv[]);
+void test_prio();
+uint64_t test_sync(uint64_t argc, char *argv[]);
+int64_t test_smp(uint64_t argc, char *argv[]);
 
 #define MAX_BLOCKS 128
 
@@ -68,6 +24,8 @@ typedef struct MM_rq {
 static void * const snakeModuleAddress = (void*)0x500000;
 
 #define MAX_BUFFER_SIZE 1024
+#define MAX_TOKENS 64
+#define MAX_PIPELINE_STAGES 8
 #define HISTORY_SIZE 10
 
 #define INC_MOD(x, m) x = (((x) + 1) % (m))
@@ -77,49 +35,87 @@ static void * const snakeModuleAddress = (void*)0x500000;
 static char buffer[MAX_BUFFER_SIZE];
 static int buffer_dim = 0;
 
-int clear(void);
-int echo(void);
-int exit(void);
-int fontdec(void);
-int font(void);
-int help(void);
-int history(void);
-int man(void);
-int snake(void);
-int regs(void);
-int time(void);
-int memtest(void);
-int memstress(void);
-int test_mm(void);
+int clear(int argc, char * argv[]);
+int echo(int argc, char * argv[]);
+int exit(int argc, char * argv[]);
+int font(int argc, char * argv[]);
+int help(int argc, char * argv[]);
+int history(int argc, char * argv[]);
+int man(int argc, char * argv[]);
+int snake(int argc, char * argv[]);
+int regs(int argc, char * argv[]);
+int time(int argc, char * argv[]);
+int mem(int argc, char * argv[]);
+int memtest(int argc, char * argv[]);
+int memstress(int argc, char * argv[]);
+int test_mm(int argc, char * argv[]);
+int syscallbench(int argc, char * argv[]);
+int syscalls(int argc, char * argv[]);
+int ps(int argc, char * argv[]);
+int kill(int argc, char * argv[]);
+int testproc(int argc, char * argv[]);
+int testprio(int argc, char * argv[]);
+int testsync(int argc, char * argv[]);
+int testsmp(int argc, char * argv[]);
+int cat(int argc, char * argv[]);
+int wc(int argc, char * argv[]);
+int interrupts(int argc, char * argv[]);
+int irqaffinity(int argc, char * argv[]);
+int cpus(int argc, char * argv[]);
+int locks(int argc, char * argv[]);
+int videobench(int argc, char * argv[]);
 
 static void printPreviousCommand(enum REGISTERABLE_KEYS scancode);
+static int tokenize(char * line, char * tokens[]);
+static int hasPipe(char * tokens[], int count);
+static int runPipeline(char * tokens[], int count);
 static void printNextCommand(enum REGISTERABLE_KEYS scancode);
 
 static uint8_t last_command_arrowed = 0;
 
+typedef int (*CommandFunction)(int argc, char * argv[]);
+
 typedef struct {
     char * name;
-    int (*function)(void);
+    CommandFunction function;
     char * description;
 } Command;
 
+static Command * findCommand(char * name);
+
 /* All available commands. Sorted alphabetically by their name */
 Command commands[] = {
-    { .name = "clear",          .function = (int (*)(void))(unsigned long long)clear,           .description = "Clears the screen" },
-    { .name = "divzero",        .function = (int (*)(void))(unsigned long long)_divzero,        .description = "Generates a division by zero exception" },
-    { .name = "echo",           .function = (int (*)(void))(unsigned long long)echo ,           .description = "Prints the input string" },
-    { .name = "exit",           .function = (int (*)(void))(unsigned long long)exit,            .description = "Command exits w/ the provided exit code or 0" },
-    { .name = "font",           .function = (int (*)(void))(unsigned long long)font,            .description = "Increases or decreases the font size.\n\t\t\t\tUse:\n\t\t\t\t\t  + font increase\n\t\t\t\t\t  + font decrease" },
-    { .name = "help",           .function = (int (*)(void))(unsigned long long)help,            .description = "Prints the available commands" },
-    { .name = "history",        .function = (int (*)(void))(unsigned long long)history,         .description = "Prints the command history" },
-    { .name = "invop",          .function = (int (*)(void))(unsigned long long)_invalidopcode,  .description = "Generates an invalid Opcode exception" },
-    { .name = "memstress",      .function = (int (*)(void))(unsigned long long)memstress,       .description = "Stress test for dynamic memory allocation" },
-    { .name = "memtest",        .function = (int (*)(void))(unsigned long long)memtest,         .description = "Simple test for dynamic memory allocation" },
-    { .name = "regs",           .function = (int (*)(void))(unsigned long long)regs,            .description = "Prints the register snapshot, if any" },
-    { .name = "man",            .function = (int (*)(void))(unsigned long long)man,             .description = "Prints the description of the provided command" },
-    { .name = "snake",          .function = (int (*)(void))(unsigned long long)snake,           .description = "Launches the snake game" },
-    { .name = "test_mm",        .function = (int (*)(void))(unsigned long long)test_mm,         .description = "Advanced memory manager test (original test_mm.c)" },
-    { .name = "time",           .function = (int (*)(void))(unsigned long long)time,            .description = "Prints the current time" },
+    { .name = "cat",            .function = (CommandFunction)(unsigned long long)cat,             .description = "Copies its input to its output, until end of file" },
+    { .name = "clear",          .function = (CommandFunction)(unsigned long long)clear,           .description = "Clears the screen" },
+    { .name = "cpus",           .function = (CommandFunction)(unsigned long long)cpus,            .description = "Measures the utilization of every CPU, idle and with one busy process per CPU" },
+    { .name = "divzero",        .function = (CommandFunction)(unsigned long long)_divzero,        .description = "Generates a division by zero exception" },
+    { .name = "echo",           .function = (CommandFunction)(unsigned long long)echo ,           .description = "Prints the input string" },
+    { .name = "exit",           .function = (CommandFunction)(unsigned long long)exit,            .description = "Command exits w/ the provided exit code or 0" },
+    { .name = "font",           .function = (CommandFunction)(unsigned long long)font,            .description = "Increases or decreases the font size.\n\t\t\t\tUse:\n\t\t\t\t\t  + font increase\n\t\t\t\t\t  + font decrease" },
+    { .name = "help",           .function = (CommandFunction)(unsigned long long)help,            .description = "Prints the available commands" },
+    { .name = "history",        .function = (CommandFunction)(unsigned long long)history,         .description = "Prints the command history" },
+    { .name = "interrupts",     .function = (CommandFunction)(unsigned long long)interrupts,      .description = "Measures timer and keyboard interrupts per second, idle and with two busy processes" },
+    { .name = "invop",          .function = (CommandFunction)(unsigned long long)_invalidopcode,  .description = "Generates an invalid Opcode exception" },
+    { .name = "irqaffinity",    .function = (CommandFunction)(unsigned long long)irqaffinity,     .description = "Steers an IRQ to the CPU with the given local APIC ID.\n\t\t\t\tUse: irqaffinity <irq> <apic id>" },
+    { .name = "kill",           .function = (CommandFunction)(unsigned long long)kill,            .description = "Kills the process with the provided pid" },
+    { .name = "locks",          .function = (CommandFunction)(unsigned long long)locks,           .description = "Prints acquisitions, contention and longest hold of every named kernel lock" },
+    { .name = "mem",            .function = (CommandFunction)(unsigned long long)mem,             .description = "Prints heap usage and slab cache statistics" },
+    { .name = "memstress",      .function = (CommandFunction)(unsigned long long)memstress,       .description = "Stress test for dynamic memory allocation" },
+    { .name = "memtest",        .function = (CommandFunction)(unsigned long long)memtest,         .description = "Simple test for dynamic memory allocation" },
+    { .name = "ps",             .function = (CommandFunction)(unsigned long long)ps,              .description = "Prints every live process" },
+    { .name = "regs",           .function = (CommandFunction)(unsigned long long)regs,            .description = "Prints the register snapshot, if any" },
+    { .name = "man",            .function = (CommandFunction)(unsigned long long)man,             .description = "Prints the description of the provided command" },
+    { .name = "snake",          .function = (CommandFunction)(unsigned long long)snake,           .description = "Launches the snake game" },
+    { .name = "syscallbench",   .function = (CommandFunction)(unsigned long long)syscallbench,    .description = "Measures cycles per null syscall, SYSCALL vs int 0x80" },
+    { .name = "syscalls",       .function = (CommandFunction)(unsigned long long)syscalls,        .description = "Prints call counts and cycles of every syscall used so far" },
+    { .name = "test_mm",        .function = (CommandFunction)(unsigned long long)test_mm,         .description = "Advanced memory manager test (original test_mm.c)" },
+    { .name = "testprio",       .function = (CommandFunction)(unsigned long long)testprio,        .description = "Runs test_prio: three printing processes at the lowest, default and highest priority" },
+    { .name = "testproc",       .function = (CommandFunction)(unsigned long long)testproc,        .description = "Runs test_processes in the background and reports process churn.\n\t\t\t\tUse: testproc <max processes> [seconds]" },
+    { .name = "testsmp",        .function = (CommandFunction)(unsigned long long)testsmp,         .description = "Runs test_smp: more endless processes than CPUs, checking every CPU stays busy.\n\t\t\t\tUse: testsmp [processes]" },
+    { .name = "testsync",       .function = (CommandFunction)(unsigned long long)testsync,        .description = "Runs test_sync without and with a semaphore, comparing cycles and context switches.\n\t\t\t\tUse: testsync <increments per process>" },
+    { .name = "time",           .function = (CommandFunction)(unsigned long long)time,            .description = "Prints the current time" },
+    { .name = "videobench",     .function = (CommandFunction)(unsigned long long)videobench,      .description = "Draws circles and rectangles and reports pixels per millisecond, flush included.\n\t\t\t\tUse: videobench [shapes of each kind]" },
+    { .name = "wc",             .function = (CommandFunction)(unsigned long long)wc,              .description = "Counts the lines, words and characters of its input" },
 };
 
 char command_history[HISTORY_SIZE][MAX_BUFFER_SIZE] = {0};
@@ -129,7 +125,7 @@ uint8_t command_history_last = 0;
 static uint64_t last_command_output = 0;
 
 int main() {
-    clear();
+    clear(0, NULL);
 
     registerKey(KP_UP_KEY, printPreviousCommand);
     registerKey(KP_DOWN_KEY, printNextCommand);
@@ -155,28 +151,23 @@ int main() {
         };
 
         buffer[buffer_dim] = 0;
-        
-        char * command = strtok(buffer, " ");
-        int i = 0;
-
-        for (; i < sizeof(commands) / sizeof(Command); i++) {
-            if (strcmp(commands[i].name, command) == 0) {
-                last_command_output = commands[i].function();
-                strncpy(command_history[command_history_last], command_history_buffer, 255);
-                command_history[command_history_last][buffer_dim] = '\0';
-                INC_MOD(command_history_last, HISTORY_SIZE);
-                last_command_arrowed = command_history_last;
-                break;
-            }
-        }
 
-        // If the command is not found, ignore \n
-        if ( i == sizeof(commands) / sizeof(Command) ) {
-            if (command != NULL && *command != '\0') {
-                fprintf(FD_STDERR, "\e[0;33mCommand not found:\e[0m %s\n", command);
-            } else if (command == NULL) {
-                printf("\n");
-            }
+        char * tokens[MAX_TOKENS + 1];
+        int token_count = tokenize(buffer, tokens);
+        char * command = tokens[0];
+        Command * found = findCommand(command);
+
+        if (found != NULL) {
+            last_command_output = hasPipe(tokens, token_count) ? runPipeline(tokens, token_count) : found->function(token_count, tokens);
+            strncpy(command_history[command_history_last], command_history_buffer, 255);
+            command_history[command_history_last][buffer_dim] = '\0';
+            INC_MOD(command_history_last, HISTORY_SIZE);
+            last_command_arrowed = command_history_last;
+        } else if (command != NULL && *command != '\0') {
+            // If the command is not found, ignore \n
+            fprintf(FD_STDERR, "\e[0;33mCommand not found:\e[0m %s\n", command);
+        } else if (command == NULL) {
+            printf("\n");
         }
     
         buffer[0] = buffer_dim = 0;
@@ -186,6 +177,100 @@ int main() {
     return 0;
 }
 
+static Command * findCommand(char * name) {
+    if (name == NULL) return NULL;
+    for (int i = 0; i < sizeof(commands) / sizeof(Command); i++)
+        if (strcmp(commands[i].name, name) == 0)
+            return &commands[i];
+    return NULL;
+}
+
+// Splits `line` in place on spaces. '|' is always a token of its own, even without spaces around it.
+// Leaves tokens NULL-terminated and returns how many there are.
+static int tokenize(char * line, char * tokens[]) {
+    static char pipeToken[] = "|";
+    int count = 0;
+    char * p = line;
+
+    while (*p != 0 && count < MAX_TOKENS) {
+        if (*p == ' ') {
+            *p++ = 0;
+        } else if (*p == '|') {
+            *p++ = 0;
+            tokens[count++] = pipeToken;
+        } else {
+            tokens[count++] = p;
+            while (*p != 0 && *p != ' ' && *p != '|') p++;
+        }
+    }
+
+    tokens[count] = NULL;
+    return count;
+}
+
+static int hasPipe(char * tokens[], int count) {
+    for (int i = 0; i < count; i++)
+        if (strcmp(tokens[i], "|") == 0) return 1;
+    return 0;
+}
+
+// Entry point of every pipeline stage: argv is the stage's own command line
+static int64_t runStage(uint64_t argc, char * argv[]) {
+    return findCommand(argv[0])->function(argc, argv);
+}
+
+// Runs `a | b | ...`: each stage is a process whose stdin/stdout were pointed at the pipes
+// in the shell's own table right before creating it, since processes inherit their creator's fds.
+// Returns the exit code of the last stage.
+static int runPipeline(char * tokens[], int count) {
+    pid_t pids[MAX_PIPELINE_STAGES];
+    int stages = 0;
+    int input = -1; // read end of the previous stage's pipe
+    int savedIn = dup(FD_STDIN), savedOut = dup(FD_STDOUT);
+
+    for (int start = 0; start <= count && stages < MAX_PIPELINE_STAGES; ) {
+        int end = start;
+        while (end < count && strcmp(tokens[end], "|") != 0) end++;
+        int last = end == count || stages == MAX_PIPELINE_STAGES - 1;
+        tokens[end] = NULL;
+
+        if (findCommand(tokens[start]) == NULL) {
+            fprintf(FD_STDERR, "\e[0;33mCommand not found:\e[0m %s\n", tokens[start] != NULL ? tokens[start] : "|");
+            break;
+        }
+
+        int fds[2] = { -1, -1 };
+        if (!last && pipe(fds) == -1) {
+            perror("Could not create pipe\n");
+            break;
+        }
+
+        dup2(input != -1 ? input : savedIn, FD_STDIN);
+        dup2(last ? savedOut : fds[1], FD_STDOUT);
+        if (input != -1) close(input);
+        if (!last) close(fds[1]);
+
+        pid_t pid = createProcess(tokens[start], runStage, end - start, &tokens[start]);
+        if (pid != -1) pids[stages++] = pid;
+
+        input = fds[0];
+        if (last) break;
+        start = end + 1;
+    }
+
+    // Back to the console. Dropping our copies of the pipe ends lets every stage see end of file
+    dup2(savedIn, FD_STDIN);
+    dup2(savedOut, FD_STDOUT);
+    close(savedIn);
+    close(savedOut);
+    if (input != -1) close(input);
+
+    int64_t status = 0;
+    for (int i = 0; i < stages; i++)
+        waitpid(pids[i], &status);
+    return status;
+}
+
 static void printPreviousCommand(enum REGISTERABLE_KEYS scancode) {
     clearInputBuffer();
     last_command_arrowed = SUB_MOD(last_command_arrowed, 1, HISTORY_SIZE);
@@ -202,7 +287,7 @@ static void printNextCommand(enum REGISTERABLE_KEYS scancode) {
     }
 }
 
-int history(void) {
+int history(int argc, char * argv[]) {
     uint8_t last = command_history_last;
     DEC_MOD(last, HISTORY_SIZE);
     uint8_t i = 0;
@@ -214,28 +299,39 @@ int history(void) {
     return 0;
 }
 
-int time(void){
+int time(int argc, char * argv[]) {
 	int hour, minute, second;
     getDate(&hour, &minute, &second);
     printf("Current time: %xh %xm %xs\n", hour, minute, second);
     return 0;
 }
 
-int echo(void){
-    for (int i = strlen("echo") + 1; i < buffer_dim; i++) {
-        switch (buffer[i]) {
+int echo(int argc, char * argv[]) {
+    // Arguments are joined back with single spaces and escapes are parsed over the whole line
+    char line[MAX_BUFFER_SIZE];
+    int line_dim = 0;
+    for (int arg = 1; arg < argc; arg++) {
+        for (int j = 0; argv[arg][j] && line_dim < MAX_BUFFER_SIZE - 2; j++)
+            line[line_dim++] = argv[arg][j];
+        if (arg < argc - 1)
+            line[line_dim++] = ' ';
+    }
+    line[line_dim] = 0;
+
+    for (int i = 0; i < line_dim; i++) {
+        switch (line[i]) {
             case '\\':
-                switch (buffer[i + 1]) {
+                switch (line[i + 1]) {
                     case 'n':
                         printf("\n");
                         i++;
                         break;
                     case 'e':
                     #ifdef ANSI_4_BIT_COLOR_SUPPORT
+                        putchar('\e'); // the console parses the rest of the sequence
                         i++;
-                        parseANSI(buffer, &i); 
                     #else 
-                        while (buffer[i] != 'm') i++; // ignores escape code, assumes valid format
+                        while (line[i] != 'm') i++; // ignores escape code, assumes valid format
                         i++;
                     #endif
                         break;
@@ -246,18 +342,18 @@ int echo(void){
                     case '\\':
                         i++;
                     default:
-                        putchar(buffer[i]);
+                        putchar(line[i]);
                         break;
                 }
                 break;
             case '$':
-                if (buffer[i + 1] == '?'){
+                if (line[i + 1] == '?'){
                     printf("%d", last_command_output);
                     i++;
                     break;
                 }
             default:
-                putchar(buffer[i]);
+                putchar(line[i]);
                 break;
         }
     }
@@ -265,7 +361,7 @@ int echo(void){
     return 0;
 }
 
-int help(void){
+int help(int argc, char * argv[]) {
     printf("Available commands:\n");
     for (int i = 0; i < sizeof(commands) / sizeof(Command); i++) {
         printf("%s%s\t ---\t%s\n", commands[i].name, strlen(commands[i].name) < 4 ? "\t" : "", commands[i].description);
@@ -274,20 +370,20 @@ int help(void){
     return 0;
 }
 
-int clear(void) {
+int clear(int argc, char * argv[]) {
     clearScreen();
     return 0;
 }
 
-int exit(void) {
-    char * buffer = strtok(NULL, " ");
+int exit(int argc, char * argv[]) {
+    char * buffer = argv[1];
     int aux = 0;
     sscanf(buffer, "%d", &aux);
     return aux;
 }
 
-int font(void) {
-    char * arg = strtok(NULL, " ");
+int font(int argc, char * argv[]) {
+    char * arg = argv[1];
     if (strcasecmp(arg, "increase") == 0) {
         return increaseFontSize();
     } else if (strcasecmp(arg, "decrease") == 0) {
@@ -298,8 +394,8 @@ int font(void) {
     return 0;
 }
 
-int man(void) {
-    char * command = strtok(NULL, " ");
+int man(int argc, char * argv[]) {
+    char * command = argv[1];
 
     if (command == NULL) {
         perror("No argument provided\n");
@@ -317,7 +413,7 @@ int man(void) {
     return 1;
 }
 
-int regs(void) {
+int regs(int argc, char * argv[]) {
     const static char * register_names[] = {
         "rax", "rbx", "rcx", "rdx", "rbp", "rdi", "rsi", "r8 ", "r9 ", "r10", "r11", "r12", "r13", "r14", "r15", "rsp", "rip", "rflags"
     };
@@ -340,11 +436,32 @@ int regs(void) {
     return 0;
 }
 
-int snake(void) {
+int snake(int argc, char * argv[]) {
     return exec(snakeModuleAddress);
 }
 
-int memtest(void) {
+int mem(int argc, char * argv[]) {
+    static MemoryStatus status;
+    getMemoryStatus(&status);
+
+    printf("Heap: %ld KiB total, %ld KiB used, %ld KiB free\n", status.total >> 10, status.used >> 10, status.free >> 10);
+    printf("Range: %lx - %lx\n", (uint64_t)status.base, (uint64_t)status.end);
+
+    if (status.slabCacheCount == 0) {
+        printf("No slab caches\n");
+        return 0;
+    }
+
+    printf("Slab caches:\n");
+    for (uint32_t i = 0; i < status.slabCacheCount; i++) {
+        SlabCacheStatus * cache = &status.slabCaches[i];
+        printf("  %s\t size %d\t in use %d/%d\t slabs %d\t allocs %ld\t frees %ld\n",
+            cache->name, cache->objectSize, cache->objectsInUse, cache->objects, cache->slabs, cache->allocs, cache->frees);
+    }
+    return 0;
+}
+
+int memtest(int argc, char * argv[]) {
     printf("Testing dynamic memory allocation...\n");
     
     // Test 1: Simple allocation and deallocation
@@ -402,7 +519,7 @@ int memtest(void) {
     return 0;
 }
 
-int memstress(void) {
+int memstress(int argc, char * argv[]) {
     printf("Stress testing dynamic memory allocation...\n");
     printf("This may take a while...\n");
     
@@ -459,14 +576,14 @@ int memstress(void) {
     return 0;
 }
 
-int test_mm(void) {
+int test_mm(int argc, char * argv[]) {
     mm_rq mm_rqs[MAX_BLOCKS];
     uint8_t rq;
     uint32_t total;
     uint64_t max_memory;
     
     // Get max_memory from user input or use default
-    char *arg = strtok(NULL, " ");
+    char *arg = argv[1];
     if (arg != NULL) {
         max_memory = satoi(arg);
         if (max_memory <= 0) {
@@ -483,6 +600,10 @@ int test_mm(void) {
     
     int iterations = 0;
     int max_iterations = 10; // Limit iterations to avoid infinite loop
+
+    // Cycle accounting, to compare allocator engines on the same workload
+    uint64_t alloc_cycles = 0, free_cycles = 0, start;
+    uint32_t alloc_calls = 0, free_calls = 0;
     
     while (iterations < max_iterations) {
         printf("Iteration %d/%d\n", iterations + 1, max_iterations);
@@ -492,7 +613,10 @@ int test_mm(void) {
         // Request as many blocks as we can
         while (rq < MAX_BLOCKS && total < max_memory) {
             mm_rqs[rq].size = GetUniform(max_memory - total - 1) + 1;
+            start = _rdtsc();
             mm_rqs[rq].address = malloc(mm_rqs[rq].size);
+            alloc_cycles += _rdtsc() - start;
+            alloc_calls++;
 
             if (mm_rqs[rq].address) {
                 total += mm_rqs[rq].size;
@@ -522,8 +646,12 @@ int test_mm(void) {
 
         // Free
         for (i = 0; i < rq; i++)
-            if (mm_rqs[i].address)
+            if (mm_rqs[i].address) {
+                start = _rdtsc();
                 free(mm_rqs[i].address);
+                free_cycles += _rdtsc() - start;
+                free_calls++;
+            }
 
         printf("  Memory freed successfully\n");
         iterations++;
@@ -531,5 +659,351 @@ int test_mm(void) {
     
     printf("Advanced memory manager test completed successfully!\n");
     printf("Completed %d iterations without errors\n", iterations);
+    printf("Average cycles per malloc: %d (%d calls)\n", (int)(alloc_cycles / (alloc_calls ? alloc_calls : 1)), alloc_calls);
+    printf("Average cycles per free:   %d (%d calls)\n", (int)(free_cycles / (free_calls ? free_calls : 1)), free_calls);
+    return 0;
+}
+
+#define SYSCALL_BENCH_ITERATIONS 100000
+
+static uint64_t benchSyscall(int32_t (*syscall)(void)) {
+    syscall(); // warm up caches and the branch predictor
+    uint64_t start = _rdtsc();
+    for (int i = 0; i < SYSCALL_BENCH_ITERATIONS; i++)
+        syscall();
+    return (_rdtsc() - start) / SYSCALL_BENCH_ITERATIONS;
+}
+
+int syscallbench(int argc, char * argv[]) {
+    printf("Null syscall, %d calls each:\n", SYSCALL_BENCH_ITERATIONS);
+    printf("  SYSCALL:  %ld cycles per call\n", benchSyscall(nullSyscall));
+    printf("  int 0x80: %ld cycles per call\n", benchSyscall(nullSyscallInt80));
+    return 0;
+}
+
+#define VIDEOBENCH_DEFAULT_SHAPES 1000
+#define VIDEOBENCH_SIZE 64
+
+// Pixels drawCircle fills for `diameter`: the same test it uses, once per pixel of the square
+static uint64_t circlePixels(int64_t diameter) {
+    int64_t radius = diameter / 2;
+    uint64_t pixels = 0;
+    for (int64_t y = -radius; y < radius; y++)
+        for (int64_t x = -radius; x < radius; x++)
+            pixels += x * x + y * y <= radius * radius;
+    return pixels;
+}
+
+// Draws `shapes` circles or rectangles spread over the screen, flushes, and returns the nanoseconds it took
+static uint64_t benchShapes(int shapes, int circles) {
+    int width = getWindowWidth() - VIDEOBENCH_SIZE;
+    int height = getWindowHeight() - VIDEOBENCH_SIZE;
+    uint64_t start = getNanoseconds();
+    for (int i = 0; i < shapes; i++) {
+        uint32_t color = (i * 0x10503F) & 0x00FFFFFF;
+        long long x = (i * 97) % width, y = (i * 61) % height;
+        if (circles)
+            drawCircle(color, x, y, VIDEOBENCH_SIZE);
+        else
+            drawRectangle(color, VIDEOBENCH_SIZE, VIDEOBENCH_SIZE, x, y);
+    }
+    flushVideo();
+    return getNanoseconds() - start;
+}
+
+static void printPixelRate(const char * kind, int shapes, uint64_t pixels, uint64_t nanoseconds) {
+    if (nanoseconds == 0) nanoseconds = 1;
+    printf("  %s: %d shapes, %ld pixels in %ld us, %ld pixels/ms\n", kind, shapes, pixels,
+        nanoseconds / 1000, pixels * 1000000 / nanoseconds);
+}
+
+int videobench(int argc, char * argv[]) {
+    int shapes = argc > 1 ? satoi(argv[1]) : VIDEOBENCH_DEFAULT_SHAPES;
+    if (shapes <= 0) {
+        perror("Use: videobench [shapes of each kind]\n");
+        return 1;
+    }
+
+    clearScreen();
+    uint64_t circleTime = benchShapes(shapes, 1);
+    uint64_t rectangleTime = benchShapes(shapes, 0);
+    clearScreen();
+
+    printf("%dx%d shapes, drawn through the syscalls:\n", VIDEOBENCH_SIZE, VIDEOBENCH_SIZE);
+    printPixelRate("circles   ", shapes, shapes * circlePixels(VIDEOBENCH_SIZE), circleTime);
+    printPixelRate("rectangles", shapes, (uint64_t) shapes * VIDEOBENCH_SIZE * VIDEOBENCH_SIZE, rectangleTime);
+    return 0;
+}
+
+int syscalls(int argc, char * argv[]) {
+    static SyscallStats stats[SYSCALL_COUNT];
+    int32_t count = getSyscallStats(stats, SYSCALL_COUNT);
+
+    printf("Syscall ABI version %d\n", SYSCALL_ABI_VERSION);
+    printf("  nr  name\t\t\t\t calls\t\t cycles/call\n");
+    for (int32_t i = 0; i < count; i++) {
+        if (stats[i].calls == 0) continue;
+        printf("  %d  %s%s\t\t %ld\t\t %ld\n", stats[i].number, stats[i].name,
+            (stats[i].flags & SYSCALL_BLOCKING) ? " (blocking)" : "", stats[i].calls, stats[i].cycles / stats[i].calls);
+    }
+    return 0;
+}
+
+static const char * const processStates[] = { "ready", "running", "blocked", "zombie" };
+
+int ps(int argc, char * argv[]) {
+    static ProcessInfo info[MAX_PROCESSES];
+    int32_t count = getProcesses(info, MAX_PROCESSES);
+
+    printf("  pid  ppid  prio  state\t\t ticks\t\t dispatches\t name\n");
+    for (int32_t i = 0; i < count; i++)
+        printf("  %d  %d  %d  %s\t\t %ld\t\t %ld\t\t %s\n", info[i].pid, info[i].ppid, info[i].priority,
+            processStates[info[i].state], info[i].ticks, info[i].dispatches, info[i].name);
+    return 0;
+}
+
+int kill(int argc, char * argv[]) {
+    char * arg = argv[1];
+    pid_t pid = satoi(arg);
+
+    if (arg == NULL || killProcess(pid) == -1) {
+        perror("Invalid pid\n");
+        return 1;
+    }
+    waitpid(pid, NULL); // collect it if it was ours
+    return 0;
+}
+
+#define TESTPROC_DEFAULT_SECONDS 5
+
+// Pids are handed out in order, so the last one test_processes got tells how many processes it created
+int testproc(int argc, char * argv[]) {
+    char * maxArg = argv[1];
+    char * secondsArg = argc > 2 ? argv[2] : NULL;
+    int64_t seconds = secondsArg ? satoi(secondsArg) : TESTPROC_DEFAULT_SECONDS;
+
+    if (maxArg == NULL || satoi(maxArg) <= 0 || seconds <= 0) {
+        perror("Use: testproc <max processes> [seconds]\n");
+        return 1;
+    }
+
+    char * testArgv[] = { maxArg };
+    pid_t tester = createProcess("test_processes", test_processes, 1, testArgv);
+    if (tester == -1) {
+        perror("Could not create test_processes\n");
+        return 1;
+    }
+
+    printf("Running test_processes %s for %ld seconds...\n", maxArg, seconds);
+    sleep(seconds * 1000);
+
+    // Freeze it first so it does not create more children while they are being killed.
+    // It can only fail to block if it already exited, i.e. the test reported an error.
+    int64_t status = 0;
+    if (blockProcess(tester) == -1) {
+        waitpid(tester, &status);
+        printf("test_processes stopped on its own (status %ld)\n", status);
+        return 1;
+    }
+
+    static ProcessInfo info[MAX_PROCESSES];
+    int32_t count = getProcesses(info, MAX_PROCESSES);
+    pid_t lastPid = tester;
+    for (int32_t i = 0; i < count; i++) {
+        if (info[i].ppid != tester) continue;
+        if (info[i].pid > lastPid) lastPid = info[i].pid;
+        killProcess(info[i].pid);
+    }
+
+    killProcess(tester);
+    waitpid(tester, NULL);
+
+    printf("test_processes created at least %d processes, %ld per second\n", lastPid - tester, (lastPid - tester) / seconds);
+    return 0;
+}
+
+int testprio(int argc, char * argv[]) {
+    test_prio();
+    return 0;
+}
+
+static void runTestSync(char * n, char * useSem) {
+    char * argv[] = { n, useSem };
+    uint64_t switches = getContextSwitches();
+    uint64_t start = _rdtsc();
+
+    test_sync(2, argv);
+
+    uint64_t cycles = _rdtsc() - start;
+    printf("  %ld cycles, %ld context switches\n", cycles, getContextSwitches() - switches);
+}
+
+#define TESTSMP_MAX_PROCESSES 64
+
+int testsmp(int argc, char * argv[]) {
+    if (argc > 1 && (satoi(argv[1]) <= 0 || satoi(argv[1]) > TESTSMP_MAX_PROCESSES)) {
+        perror("Use: testsmp [processes], at most 64\n");
+        return 1;
+    }
+    return test_smp(argc - 1, argv + 1) == -1;
+}
+
+int testsync(int argc, char * argv[]) {
+    char * n = argv[1];
+    if (n == NULL || satoi(n) <= 0) {
+        perror("Use: testsync <increments per process>\n");
+        return 1;
+    }
+
+    printf("Without semaphore (racy, the final value is rarely 0):\n");
+    runTestSync(n, "0");
+    printf("With semaphore (the final value must be 0):\n");
+    runTestSync(n, "1");
+    return 0;
+}
+
+int cat(int argc, char * argv[]) {
+    int c;
+    while ((c = getchar()) != EOF)
+        putchar(c);
+    return 0;
+}
+
+int wc(int argc, char * argv[]) {
+    uint64_t lines = 0, words = 0, characters = 0;
+    int c, inWord = 0;
+
+    while ((c = getchar()) != EOF) {
+        characters++;
+        if (c == '\n') lines++;
+        if (c == ' ' || c == '\t' || c == '\n') {
+            inWord = 0;
+        } else if (!inWord) {
+            inWord = 1;
+            words++;
+        }
+    }
+
+    printf("%ld lines, %ld words, %ld characters\n", lines, words, characters);
+    return 0;
+}
+
+static int64_t spin(uint64_t argc, char * argv[]) {
+    while (1);
+    return 0;
+}
+
+// Samples the interrupt counters across one second and prints their rates
+static void printInterruptRates(const char * label) {
+    InterruptStats before, after;
+    getInterruptStats(&before);
+    uint64_t start = getNanoseconds();
+    sleep(1000);
+    getInterruptStats(&after);
+    uint64_t elapsed = getNanoseconds() - start;
+    if (elapsed == 0) elapsed = 1;
+
+    printf("  %s:	%ld timer, %ld keyboard interrupts/s (%ld ticks/s)\n", label,
+        (after.timer - before.timer) * NANOSECONDS_PER_SECOND / elapsed,
+        (after.keyboard - before.keyboard) * NANOSECONDS_PER_SECOND / elapsed,
+        (after.ticks - before.ticks) * NANOSECONDS_PER_SECOND / elapsed);
+}
+
+int interrupts(int argc, char * argv[]) {
+    InterruptStats stats;
+    getInterruptStats(&stats);
+    printf("Timer: %s\n", stats.tickless ? "tickless, local APIC one-shot" : "periodic PIT");
+    if (stats.keyboardCpu >= 0)
+        printf("Routing: IO-APIC, keyboard on APIC ID %d\n", stats.keyboardCpu);
+    else
+        printf("Routing: 8259 PIC\n");
+
+    printInterruptRates("Idle");
+
+    // Two of them, so there is always someone ready and the quantum has to be enforced
+    pid_t spinners[2];
+    for (int i = 0; i < 2; i++)
+        spinners[i] = createProcess("spin", spin, 0, NULL);
+    printInterruptRates("Busy");
+
+    for (int i = 0; i < 2; i++) {
+        if (spinners[i] != -1) {
+            killProcess(spinners[i]);
+            waitpid(spinners[i], NULL);
+        }
+    }
+    return 0;
+}
+
+int irqaffinity(int argc, char * argv[]) {
+    if (argc != 3 || satoi(argv[1]) < 0 || satoi(argv[2]) < 0) {
+        perror("Use: irqaffinity <irq> <apic id>\n");
+        return 1;
+    }
+    if (setIrqAffinity(satoi(argv[1]), satoi(argv[2])) == -1) {
+        perror("Could not steer the IRQ: not routed through the IO-APIC, or no such CPU\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Samples the per-CPU counters across one second and prints how busy each CPU was
+static void printCpuUsage(const char * label) {
+    static CpuInfo before[MAX_CPUS], after[MAX_CPUS];
+    int32_t count = getCpuStats(before, MAX_CPUS);
+    sleep(1000);
+    getCpuStats(after, MAX_CPUS);
+
+    printf("  %s:\n", label);
+    for (int32_t i = 0; i < count; i++) {
+        uint64_t busy = after[i].busyTicks - before[i].busyTicks;
+        uint64_t total = busy + after[i].idleTicks - before[i].idleTicks;
+        if (total == 0) total = 1;
+        printf("    CPU %d (APIC ID %d):\t%ld%% busy, %ld dispatches, %ld steals\n", i, after[i].apicId,
+            busy * 100 / total, after[i].dispatches - before[i].dispatches, after[i].steals - before[i].steals);
+    }
+}
+
+int cpus(int argc, char * argv[]) {
+    static CpuInfo info[MAX_CPUS];
+    int32_t count = getCpuStats(info, MAX_CPUS);
+    printf("%d CPU%s online\n", count, count == 1 ? "" : "s");
+
+    printCpuUsage("Idle");
+
+    // One per CPU: with the shell asleep, each of them should end up on a CPU of its own
+    pid_t spinners[MAX_CPUS];
+    for (int32_t i = 0; i < count; i++)
+        spinners[i] = createProcess("spin", spin, 0, NULL);
+    printCpuUsage("Busy");
+
+    for (int32_t i = 0; i < count; i++) {
+        if (spinners[i] != -1) {
+            killProcess(spinners[i]);
+            waitpid(spinners[i], NULL);
+        }
+    }
+
+    getCpuStats(info, MAX_CPUS);
+    printf("  Run queues:\n");
+    for (int32_t i = 0; i < count; i++)
+        printf("    CPU %d:\t%d queued, %d at most, %ld enqueued, %ld stolen by others\n", i,
+            info[i].queued, info[i].maxQueued, info[i].enqueued, info[i].stolen);
+    return 0;
+}
+
+int locks(int argc, char * argv[]) {
+    static LockInfo info[MAX_LOCKS];
+    static const char * kinds[] = { "spin", "rw" };
+    int32_t count = getLockStats(info, MAX_LOCKS);
+    if (count == -1) {
+        perror("Could not read the lock statistics\n");
+        return 1;
+    }
+
+    printf("NAME\t\tKIND\tACQUIRED\tCONTENDED\tSPINS\t\tMAX HOLD (cycles)\n");
+    for (int32_t i = 0; i < count; i++)
+        printf("%s\t%s%s\t%ld\t\t%ld\t\t%ld\t\t%ld\n", info[i].name, strlen(info[i].name) < 8 ? "\t" : "",
+            kinds[info[i].kind], info[i].acquisitions, info[i].contended, info[i].contentionSpins, info[i].maxHoldCycles);
     return 0;
 }
@@ -192,6 +192,7 @@ int main(void) {
         while(!end_of_game) {
             drawSnakes();
             drawFood();
+            flushVideo();   // the whole frame at once
         
             sleep(difficulty_level);
 
@@ -7,4 +7,13 @@ int rand(void);
 
 void srand(unsigned int seed);
 
+// Heap allocation, served from a local arena (see libc/malloc.c)
+void * malloc(size_t size);
+
+void free(void * ptr);
+
+void * realloc(void * ptr, size_t size);
+
+void * calloc(size_t count, size_t size);
+
 #endif
\ No newline at end of file
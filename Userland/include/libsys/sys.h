@@ -2,6 +2,12 @@
 #define _SYS_H_
 
 #include <stdint.h>
+#include <syscallTable.h>
+#include <processInfo.h>
+#include <clock.h>
+#include <interruptStats.h>
+#include <cpuInfo.h>
+#include <lockInfo.h>
 
 // Enum of registerable keys.
 // Note: Does not include TAB or RETURN
@@ -117,10 +123,95 @@ void sleep(uint32_t milliseconds);
 int32_t getRegisterSnapshot(int64_t * registers);
 int32_t getCharacterWithoutDisplay(void);
 
+// Empty syscall through the SYSCALL fast path / the int 0x80 compatibility path
+int32_t nullSyscall(void);
+int32_t nullSyscallInt80(void);
+
+// Per-syscall counters kept by the kernel, returns how many entries were filled
+int32_t getSyscallStats(SyscallStats * stats, uint32_t maxEntries);
+
+// Processes. Every process shares the address space; argv is copied by the kernel.
+// createProcess returns the new pid or -1; the others return -1 when the pid is not valid for them.
+pid_t createProcess(const char * name, ProcessEntry entry, uint64_t argc, char * argv[]);
+pid_t getpid(void);
+void yield(void);
+int32_t killProcess(pid_t pid);
+pid_t waitpid(pid_t pid, int64_t * status); // pid -1 waits for any child
+int32_t blockProcess(pid_t pid);
+int32_t unblockProcess(pid_t pid);
+int32_t nice(pid_t pid, uint8_t priority); // PRIORITY_LOWEST..PRIORITY_HIGHEST
+int32_t getProcesses(ProcessInfo * info, uint32_t maxEntries);
+void exitProcess(int64_t code);
+uint64_t getContextSwitches(void); // since boot
+
+// Named counting semaphores. semOpen creates the semaphore with `initialValue` the
+// first time and returns its id, or -1; every open must be paired with a semClose.
+int32_t semOpen(const char * name, uint32_t initialValue);
+int32_t semWait(int32_t id);
+int32_t semPost(int32_t id);
+int32_t semClose(int32_t id);
+
+// File descriptors. New processes start with a copy of their creator's table.
+// pipe leaves the read end in fds[0] and the write end in fds[1]; all return -1 on error.
+int32_t pipe(int32_t fds[2]);
+int32_t close(int32_t fd);
+int32_t dup(int32_t fd);
+int32_t dup2(int32_t fd, int32_t target);
+// Opens a device by name: "keyboard", "console", "error" (console in the error color) or "null"
+int32_t open(const char * name);
+
+// Monotonic clock with nanosecond resolution (TSC based, calibrated at boot).
+// clockGetTime returns -1 for a clock other than CLOCK_MONOTONIC.
+int32_t clockGetTime(uint32_t clockId, Timespec * ts);
+uint64_t getNanoseconds(void);  // since boot
+
+int32_t getInterruptStats(InterruptStats * stats);
+
+// Steers ISA `irq` to the CPU whose local APIC ID is `apicId`.
+// Returns -1 under the 8259, for an IRQ that is not routed or a CPU that is not running.
+int32_t setIrqAffinity(uint8_t irq, uint8_t apicId);
+
+// Fills `info` with up to `maxEntries` online CPUs (at most MAX_CPUS) and returns how many were filled
+int32_t getCpuStats(CpuInfo * info, uint32_t maxEntries);
+
+// Fills `info` with up to `maxEntries` named kernel locks (at most MAX_LOCKS) and returns how many were filled
+int32_t getLockStats(LockInfo * info, uint32_t maxEntries);
+
+// Shows everything drawn so far right away; otherwise the kernel copies it to the screen within a frame
+void flushVideo(void);
+
+// Has the kernel reset `lock` (0 when free, else its holder's pid) when its holder dies; once per lock word
+int32_t registerRobustLock(volatile pid_t * lock);
+
+// Memory status, mirrors the kernel's MemoryStatus (Kernel/include/defs.h)
+#define MAX_SLAB_CACHES  16
+#define SLAB_NAME_LENGTH 16
+
+typedef struct {
+    char     name[SLAB_NAME_LENGTH];
+    uint32_t objectSize;
+    uint32_t slabs;
+    uint32_t objects;
+    uint32_t objectsInUse;
+    uint64_t allocs;
+    uint64_t frees;
+} SlabCacheStatus;
+
+typedef struct {
+    uint64_t total;
+    uint64_t used;
+    uint64_t free;
+    void    *base;
+    void    *end;
+    uint32_t slabCacheCount;
+    SlabCacheStatus slabCaches[MAX_SLAB_CACHES];
+} MemoryStatus;
+
 // Memory management wrappers (provided by libsys)
-// These are thin wrappers that call kernel syscalls via libsys
-int32_t getMemoryStatus(void *memStatus);
-void *malloc(int size);
-int32_t free(void *ptr);
+// malloc/free live in libc (stdlib.h) and only reach the kernel for arena chunks and large blocks
+int32_t getMemoryStatus(MemoryStatus *memStatus);
+
+// Reads the CPU time stamp counter, used by benchmarking commands
+uint64_t _rdtsc(void);
 
 #endif /* _SYS_H_ */
\ No newline at end of file
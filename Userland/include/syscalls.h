@@ -3,37 +3,32 @@
 
 #include <stdint.h>
 #include <sys.h>
+#include <syscallTable.h>
 
-// Linux syscall prototypes
+// Raw entry points (libsys/asm/libsys.asm), numbers are SYS_* from syscallTable.h
+int64_t _syscall(uint64_t number, uint64_t arg0, uint64_t arg1, uint64_t arg2, uint64_t arg3, uint64_t arg4);
+int64_t _syscall_int80(uint64_t number, uint64_t arg0, uint64_t arg1, uint64_t arg2, uint64_t arg3, uint64_t arg4);
+
+int32_t sys_abi_version(void);
+
+// Linux-like syscall prototypes
 int32_t sys_write(int64_t fd, const void * buf, int64_t count);
 int32_t sys_read(int64_t fd, void * buf, int64_t count);
 
 // Custom syscall prototypes
-/* 0x80000000 */
 int32_t sys_start_beep(uint32_t nFrequence);
-/* 0x80000001 */
 int32_t sys_stop_beep(void);
-/* 0x80000002 */
 int32_t sys_fonts_text_color(uint32_t color);
-/* 0x80000003 */
 int32_t sys_fonts_background_color(uint32_t color);
-/* 0x80000007 */
 int32_t sys_fonts_decrease_size(void);
-/* 0x80000008 */
 int32_t sys_fonts_increase_size(void);
-/* 0x80000009 */
 int32_t sys_fonts_set_size(uint8_t size);
-/* 0x8000000A */
 int32_t sys_clear_screen(void);
-/* 0x8000000B */
 int32_t sys_clear_input_buffer(void);
 
 // Date syscall prototypes
-/* 0x80000010 */
 int32_t sys_hour(int * hour);
-/* 0x80000011 */
 int32_t sys_minute(int * minute);
-/* 0x80000012 */
 int32_t sys_second(int * second);
 
 int32_t sys_circle(int color, long long int topleftX, long long int topLefyY, long long int diameter);
@@ -56,14 +51,53 @@ int32_t sys_get_register_snapshot(int64_t * registers);
 
 int32_t sys_get_character_without_display(void);
 
+/* Syscall path benchmarking, both enter sys_null */
+int32_t sys_null(void);
+int32_t sys_null_int80(void);
+
 /* Memory management syscalls */
-/* 0x80000100 */
 int32_t sys_get_mem_status(void *memStatus);
-/* 0x80000101 */
-void *sys_malloc(int size);
-/* 0x80000102 */
+void *sys_malloc(uint64_t size);
 int32_t sys_free(void *ptr);
-
-
-
-#endif
\ No newline at end of file
+void *sys_realloc(void *ptr, uint64_t size);
+void *sys_calloc(uint64_t count, uint64_t size);
+
+/* Per-syscall call counts and cycles, returns how many entries were filled */
+int32_t sys_get_syscall_stats(SyscallStats * stats, uint32_t maxEntries);
+
+/* Process syscalls */
+pid_t sys_create_process(const char * name, ProcessEntry entry, uint64_t argc, char * argv[]);
+pid_t sys_getpid(void);
+int32_t sys_yield(void);
+int32_t sys_kill(pid_t pid);
+pid_t sys_waitpid(pid_t pid, int64_t * status);
+int32_t sys_block(pid_t pid);
+int32_t sys_unblock(pid_t pid);
+int32_t sys_nice(pid_t pid, uint8_t priority);
+int32_t sys_get_processes(ProcessInfo * info, uint32_t maxEntries);
+int32_t sys_exit(int64_t code);
+uint64_t sys_context_switches(void);
+
+/* Semaphore syscalls */
+int32_t sys_sem_open(const char * name, uint32_t initialValue);
+int32_t sys_sem_wait(int32_t id);
+int32_t sys_sem_post(int32_t id);
+int32_t sys_sem_close(int32_t id);
+
+/* File descriptor syscalls */
+int32_t sys_pipe(int32_t fds[2]);
+int32_t sys_close(int32_t fd);
+int32_t sys_dup(int32_t fd);
+int32_t sys_dup2(int32_t fd, int32_t target);
+int32_t sys_open(const char * name);
+
+/* Clock syscalls */
+int32_t sys_clock_gettime(uint32_t clockId, Timespec * ts);
+int32_t sys_get_interrupt_stats(InterruptStats * stats);
+int32_t sys_set_irq_affinity(uint8_t irq, uint8_t apicId);
+int32_t sys_get_cpu_stats(CpuInfo * info, uint32_t maxEntries);
+int32_t sys_get_lock_stats(LockInfo * info, uint32_t maxEntries);
+int32_t sys_flush_video(void);
+int32_t sys_register_robust_lock(volatile pid_t * lock);
+
+#endif
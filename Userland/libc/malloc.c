@@ -0,0 +1,175 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <syscalls.h>
+
+// Userland heap.
+// Small requests are served from per-size-class bins, refilled by carving a
+// local arena that is grown in ARENA_CHUNK_SIZE steps with a single syscall.
+// Only requests larger than the biggest class go to the kernel each time.
+// Every program links its own copy, so bins are private to each module, but
+// they are shared by every process started from it: the timer may preempt one
+// of them halfway through an update, so the bins and the arena are guarded by
+// a spinlock that yields the CPU while somebody else holds it. The lock holds
+// its owner's pid and is registered as robust, so a process killed while
+// holding it does not leave every other malloc spinning forever.
+
+#define ARENA_CHUNK_SIZE (64 * 1024)
+#define LARGE_CLASS 0xFFFFFFFF
+#define HEADER_MAGIC 0xA110CA7E
+
+typedef struct {
+    uint32_t magic;
+    uint32_t sizeClass; // index into classSizes, or LARGE_CLASS
+} AllocHeader;          // 8 bytes, so payloads keep 8-byte alignment
+
+typedef struct FreeObject {
+    struct FreeObject * next;
+} FreeObject;
+
+static const uint32_t classSizes[] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048 };
+
+#define NUM_CLASSES (sizeof(classSizes) / sizeof(*classSizes))
+#define MAX_SMALL_SIZE 2048
+#define MAX_LARGE_SIZE (SIZE_MAX - sizeof(AllocHeader))  // more would wrap once the header is added
+
+static FreeObject * bins[NUM_CLASSES];
+static uint8_t * arenaCursor = NULL;
+static uint8_t * arenaEnd = NULL;
+static volatile pid_t heapLock = 0;     // pid of the holder, 0 when free
+static volatile uint8_t heapLockRegistered = 0;
+
+static void lock(void) {
+    if (!heapLockRegistered) {
+        sys_register_robust_lock(&heapLock);   // two processes racing here register it twice, which is harmless
+        heapLockRegistered = 1;
+    }
+
+    pid_t self = sys_getpid();
+    pid_t free = 0;
+    while (!__atomic_compare_exchange_n(&heapLock, &free, self, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        free = 0;
+        sys_yield();
+    }
+}
+
+static void unlock(void) {
+    __atomic_store_n(&heapLock, 0, __ATOMIC_RELEASE);
+}
+
+static uint32_t sizeClass(size_t size) {
+    uint32_t c = 0;
+    while (classSizes[c] < size) c++;
+    return c;
+}
+
+// Carves one slot of class `c` from the arena, growing it when exhausted
+static AllocHeader * carve(uint32_t c) {
+    uint32_t slot = sizeof(AllocHeader) + classSizes[c];
+
+    if (arenaCursor == NULL || arenaEnd - arenaCursor < slot) {
+        uint8_t * chunk = sys_malloc(ARENA_CHUNK_SIZE);
+        if (chunk == NULL) return NULL;
+        arenaCursor = chunk;
+        arenaEnd = chunk + ARENA_CHUNK_SIZE;
+    }
+
+    AllocHeader * header = (AllocHeader *) arenaCursor;
+    arenaCursor += slot;
+    return header;
+}
+
+static void * tagLarge(AllocHeader * header) {
+    if (header == NULL) return NULL;
+    header->sizeClass = LARGE_CLASS;
+    header->magic = HEADER_MAGIC;
+    return header + 1;
+}
+
+void * malloc(size_t size) {
+    if (size == 0) return NULL;
+    if (size > MAX_LARGE_SIZE) return NULL;
+    if (size > MAX_SMALL_SIZE) return tagLarge(sys_malloc(sizeof(AllocHeader) + size));
+
+    AllocHeader * header;
+    uint32_t c = sizeClass(size);
+    lock();
+    if (bins[c] != NULL) {
+        header = (AllocHeader *) bins[c] - 1;
+        bins[c] = bins[c]->next;
+    } else if ((header = carve(c)) == NULL) {
+        unlock();
+        return NULL;
+    }
+    unlock();
+
+    header->sizeClass = c;
+    header->magic = HEADER_MAGIC;
+    return header + 1;
+}
+
+void free(void * ptr) {
+    if (ptr == NULL) return;
+
+    AllocHeader * header = (AllocHeader *) ptr - 1;
+    if (header->magic != HEADER_MAGIC) return; // not ours, or already freed
+
+    header->magic = 0;
+
+    if (header->sizeClass == LARGE_CLASS) {
+        sys_free(header);
+        return;
+    }
+
+    FreeObject * object = (FreeObject *) ptr;
+    lock();
+    object->next = bins[header->sizeClass];
+    bins[header->sizeClass] = object;
+    unlock();
+}
+
+// Large blocks are resized by the kernel, which grows them in place when it can.
+// Small blocks stay put while the new size still fits their class.
+void * realloc(void * ptr, size_t size) {
+    if (ptr == NULL) return malloc(size);
+    if (size == 0) {
+        free(ptr);
+        return NULL;
+    }
+
+    AllocHeader * header = (AllocHeader *) ptr - 1;
+    if (header->magic != HEADER_MAGIC) return NULL;
+
+    if (header->sizeClass == LARGE_CLASS) {
+        if (size <= MAX_SMALL_SIZE / 2) { // worth moving back into a bin
+            uint8_t * moved = malloc(size);
+            if (moved == NULL) return NULL;
+            for (size_t i = 0; i < size; i++) moved[i] = ((uint8_t *) ptr)[i];
+            free(ptr);
+            return moved;
+        }
+        if (size > MAX_LARGE_SIZE) return NULL;
+        return tagLarge(sys_realloc(header, sizeof(AllocHeader) + size));
+    }
+
+    size_t oldSize = classSizes[header->sizeClass];
+    if (size <= oldSize) return ptr;
+
+    uint8_t * moved = malloc(size);
+    if (moved == NULL) return NULL;
+    for (size_t i = 0; i < oldSize; i++) moved[i] = ((uint8_t *) ptr)[i];
+    free(ptr);
+    return moved;
+}
+
+void * calloc(size_t count, size_t size) {
+    if (count != 0 && size > SIZE_MAX / count) return NULL;
+
+    size_t total = count * size;
+    if (total > MAX_LARGE_SIZE) return NULL;
+    if (total > MAX_SMALL_SIZE) return tagLarge(sys_calloc(1, sizeof(AllocHeader) + total));
+
+    uint8_t * ptr = malloc(total);
+    if (ptr == NULL) return NULL;
+    for (size_t i = 0; i < total; i++) ptr[i] = 0;
+    return ptr;
+}
@@ -2,14 +2,10 @@
 #include <string.h>
 #include <syscalls.h>
 
-#ifdef ANSI_4_BIT_COLOR_SUPPORT
-    #include <ansiColors.h>
-#endif
-
 static char buffer[64] = {0};
 
 static uint32_t uintToBase(uint64_t value, char * buffer, uint32_t base);
-static void printBase(int fd, int num, int base);
+static void printBase(int fd, int64_t num, int base);
 // static void printFloat(int fd, float num);
 
 void puts(const char * str) {
@@ -17,16 +13,21 @@ void puts(const char * str) {
     printf("\n");
 }
 
+// Characters that can go out as they are, in the same write as their neighbours
+static inline int isPlainCharacter(char c) {
+#ifdef ANSI_4_BIT_COLOR_SUPPORT
+    return c != 0 && c != '%'; // color escapes are parsed by the console, per stream
+#else
+    return c != 0 && c != '%' && c != '\e';
+#endif
+}
+
 void vfprintf(int fd, const char * format, va_list args) {
     int i = 0;
     while (format[i] != 0) {
         switch (format[i]) {
+        #ifndef ANSI_4_BIT_COLOR_SUPPORT
         case '\e':
-        #ifdef ANSI_4_BIT_COLOR_SUPPORT
-            sys_write(fd, &format[i], 0); // "writes" (ignored because of count=0) \e char to account for fd changes
-            parseANSI(format, &i);
-            break ;
-        #else
             while(format[i] != 'm') i++; // ignore ANSI escape codes, assumes valid \e[X,Ym format
             i++;
             break ;
@@ -38,22 +39,38 @@ void vfprintf(int fd, const char * format, va_list args) {
                 case 'd': printBase(fd, va_arg(args, int), 10); break ;
                 case 'o': printBase(fd, va_arg(args, int), 8); break ;
                 case 'b': printBase(fd, va_arg(args, int), 2); break ;
+                case 'l': // 64-bit variants: %lx %ld %lo %lb
+                    i++;
+                    switch (format[i]) {
+                        case 'x': printBase(fd, va_arg(args, int64_t), 16); break ;
+                        case 'd': printBase(fd, va_arg(args, int64_t), 10); break ;
+                        case 'o': printBase(fd, va_arg(args, int64_t), 8); break ;
+                        case 'b': printBase(fd, va_arg(args, int64_t), 2); break ;
+                    }
+                    break ;
                 // case 'f': printFloat(fd, va_arg(args, double)); break ;
                 case 'c': {
                     char c = (char) va_arg(args, int);
                     sys_write(fd, &c, 1);
                     break ;
                 }
-                case 's': fprintf(fd, va_arg(args, char *)); break ;
+                case 's': {
+                    char * s = va_arg(args, char *);
+                    sys_write(fd, s, strlen(s));
+                    break ;
+                }
                 case '%': sys_write(fd, "%", 1); break ;
             }
             i++;
             break ;
-        default:
-            sys_write(fd, &format[i], 1);
-            i++;
+        default: {
+            // One write for the whole run of plain text, instead of one per character
+            int start = i;
+            while (isPlainCharacter(format[i])) i++;
+            sys_write(fd, &format[start], i - start);
             break ;
         }
+        }
     }
 }
 
@@ -193,9 +210,10 @@ void perror(const char * s1) {
     fprintf(FD_STDERR, s1);
 }
 
+// Returns EOF when stdin is a pipe with no writers left, or on a bad fd
 int getchar(void) {
     signed char c[1];
-    while(sys_read(FD_STDIN, c, 1) == -1);
+    if (sys_read(FD_STDIN, c, 1) <= 0) return EOF;
     return c[0];
 }
 
@@ -236,7 +254,7 @@ static uint32_t uintToBase(uint64_t value, char * buffer, uint32_t base)
 	return digits;
 }
 
-static void printBase(int fd, int num, int base) {
+static void printBase(int fd, int64_t num, int base) {
     if (num < 0) fprintf(fd, "-");
     uintToBase(num, buffer, base);
     fprintf(fd, buffer);
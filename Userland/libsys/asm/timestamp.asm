@@ -0,0 +1,16 @@
+GLOBAL _rdtsc
+
+section .text
+
+; Returns the 64-bit time stamp counter (cycles since reset)
+_rdtsc:
+    push rbp
+    mov rbp, rsp
+
+    rdtsc
+    shl rdx, 32
+    or rax, rdx
+
+    mov rsp, rbp
+    pop rbp
+    ret
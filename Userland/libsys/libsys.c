@@ -84,15 +84,138 @@ int32_t getCharacterWithoutDisplay(void) {
     return sys_get_character_without_display();
 }
 
+int32_t nullSyscall(void) {
+    return sys_null();
+}
+
+int32_t nullSyscallInt80(void) {
+    return sys_null_int80();
+}
+
+int32_t getSyscallStats(SyscallStats * stats, uint32_t maxEntries) {
+    return sys_get_syscall_stats(stats, maxEntries);
+}
+
 /* Memory management wrappers */
-int32_t getMemoryStatus(void *memStatus) {
+int32_t getMemoryStatus(MemoryStatus *memStatus) {
     return sys_get_mem_status(memStatus);
 }
 
-void *malloc(int size) {
-    return sys_malloc(size);
+/* Process wrappers */
+pid_t createProcess(const char * name, ProcessEntry entry, uint64_t argc, char * argv[]) {
+    return sys_create_process(name, entry, argc, argv);
+}
+
+pid_t getpid(void) {
+    return sys_getpid();
+}
+
+void yield(void) {
+    sys_yield();
+}
+
+int32_t killProcess(pid_t pid) {
+    return sys_kill(pid);
+}
+
+pid_t waitpid(pid_t pid, int64_t * status) {
+    return sys_waitpid(pid, status);
+}
+
+int32_t blockProcess(pid_t pid) {
+    return sys_block(pid);
+}
+
+int32_t unblockProcess(pid_t pid) {
+    return sys_unblock(pid);
+}
+
+int32_t nice(pid_t pid, uint8_t priority) {
+    return sys_nice(pid, priority);
+}
+
+int32_t getProcesses(ProcessInfo * info, uint32_t maxEntries) {
+    return sys_get_processes(info, maxEntries);
+}
+
+void exitProcess(int64_t code) {
+    sys_exit(code);
+    __builtin_unreachable();
+}
+
+uint64_t getContextSwitches(void) {
+    return sys_context_switches();
+}
+
+/* Semaphore wrappers */
+int32_t semOpen(const char * name, uint32_t initialValue) {
+    return sys_sem_open(name, initialValue);
+}
+
+int32_t semWait(int32_t id) {
+    return sys_sem_wait(id);
 }
 
-int32_t free(void *ptr) {
-    return sys_free(ptr);
-}
\ No newline at end of file
+int32_t semPost(int32_t id) {
+    return sys_sem_post(id);
+}
+
+int32_t semClose(int32_t id) {
+    return sys_sem_close(id);
+}
+
+/* File descriptor wrappers */
+int32_t pipe(int32_t fds[2]) {
+    return sys_pipe(fds);
+}
+
+int32_t close(int32_t fd) {
+    return sys_close(fd);
+}
+
+int32_t dup(int32_t fd) {
+    return sys_dup(fd);
+}
+
+int32_t dup2(int32_t fd, int32_t target) {
+    return sys_dup2(fd, target);
+}
+
+int32_t open(const char * name) {
+    return sys_open(name);
+}
+
+int32_t clockGetTime(uint32_t clockId, Timespec * ts) {
+    return sys_clock_gettime(clockId, ts);
+}
+
+int32_t getInterruptStats(InterruptStats * stats) {
+    return sys_get_interrupt_stats(stats);
+}
+
+int32_t setIrqAffinity(uint8_t irq, uint8_t apicId) {
+    return sys_set_irq_affinity(irq, apicId);
+}
+
+int32_t getCpuStats(CpuInfo * info, uint32_t maxEntries) {
+    return sys_get_cpu_stats(info, maxEntries);
+}
+
+int32_t getLockStats(LockInfo * info, uint32_t maxEntries) {
+    return sys_get_lock_stats(info, maxEntries);
+}
+
+void flushVideo(void) {
+    sys_flush_video();
+}
+
+int32_t registerRobustLock(volatile pid_t * lock) {
+    return sys_register_robust_lock(lock);
+}
+
+uint64_t getNanoseconds(void) {
+    Timespec ts;
+    if (sys_clock_gettime(CLOCK_MONOTONIC, &ts) == -1)
+        return 0;
+    return ts.seconds * NANOSECONDS_PER_SECOND + ts.nanoseconds;
+}
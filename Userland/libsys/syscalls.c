@@ -0,0 +1,245 @@
+#include <syscalls.h>
+
+// Typed wrappers over the raw entry points, one per entry of SYSCALL_LIST
+
+#define ARG(x) ((uint64_t)(x))
+
+int32_t sys_abi_version(void) {
+    return _syscall(SYS_abi_version, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_write(int64_t fd, const void * buf, int64_t count) {
+    return _syscall(SYS_write, fd, ARG(buf), count, 0, 0);
+}
+
+int32_t sys_read(int64_t fd, void * buf, int64_t count) {
+    return _syscall(SYS_read, fd, ARG(buf), count, 0, 0);
+}
+
+int32_t sys_start_beep(uint32_t nFrequence) {
+    return _syscall(SYS_start_beep, nFrequence, 0, 0, 0, 0);
+}
+
+int32_t sys_stop_beep(void) {
+    return _syscall(SYS_stop_beep, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_fonts_text_color(uint32_t color) {
+    return _syscall(SYS_fonts_text_color, color, 0, 0, 0, 0);
+}
+
+int32_t sys_fonts_background_color(uint32_t color) {
+    return _syscall(SYS_fonts_background_color, color, 0, 0, 0, 0);
+}
+
+int32_t sys_fonts_decrease_size(void) {
+    return _syscall(SYS_fonts_decrease_size, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_fonts_increase_size(void) {
+    return _syscall(SYS_fonts_increase_size, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_fonts_set_size(uint8_t size) {
+    return _syscall(SYS_fonts_set_size, size, 0, 0, 0, 0);
+}
+
+int32_t sys_clear_screen(void) {
+    return _syscall(SYS_clear_screen, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_clear_input_buffer(void) {
+    return _syscall(SYS_clear_input_buffer, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_hour(int * hour) {
+    return _syscall(SYS_hour, ARG(hour), 0, 0, 0, 0);
+}
+
+int32_t sys_minute(int * minute) {
+    return _syscall(SYS_minute, ARG(minute), 0, 0, 0, 0);
+}
+
+int32_t sys_second(int * second) {
+    return _syscall(SYS_second, ARG(second), 0, 0, 0, 0);
+}
+
+int32_t sys_circle(int color, long long int topleftX, long long int topLefyY, long long int diameter) {
+    return _syscall(SYS_circle, (uint32_t)color, topleftX, topLefyY, diameter, 0);
+}
+
+int32_t sys_rectangle(int color, long long int width_pixels, long long int height_pixels, long long int initial_pos_x, long long int initial_pos_y) {
+    return _syscall(SYS_rectangle, (uint32_t)color, width_pixels, height_pixels, initial_pos_x, initial_pos_y);
+}
+
+int32_t sys_fill_video_memory(uint32_t hexColor) {
+    return _syscall(SYS_fill_video_memory, hexColor, 0, 0, 0, 0);
+}
+
+int32_t sys_exec(int32_t (*fnPtr)(void)) {
+    return _syscall(SYS_exec, ARG(fnPtr), 0, 0, 0, 0);
+}
+
+int32_t sys_register_key(uint8_t scancode, void (*fn)(enum REGISTERABLE_KEYS scancode)) {
+    return _syscall(SYS_register_key, scancode, ARG(fn), 0, 0, 0);
+}
+
+int32_t sys_window_width(void) {
+    return _syscall(SYS_window_width, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_window_height(void) {
+    return _syscall(SYS_window_height, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_sleep_milis(uint32_t milis) {
+    return _syscall(SYS_sleep_milis, milis, 0, 0, 0, 0);
+}
+
+int32_t sys_get_register_snapshot(int64_t * registers) {
+    return _syscall(SYS_get_register_snapshot, ARG(registers), 0, 0, 0, 0);
+}
+
+int32_t sys_get_character_without_display(void) {
+    return _syscall(SYS_get_character_without_display, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_null(void) {
+    return _syscall(SYS_null, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_null_int80(void) {
+    return _syscall_int80(SYS_null, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_get_mem_status(void *memStatus) {
+    return _syscall(SYS_get_mem_status, ARG(memStatus), 0, 0, 0, 0);
+}
+
+void *sys_malloc(uint64_t size) {
+    return (void *)_syscall(SYS_malloc, size, 0, 0, 0, 0);
+}
+
+int32_t sys_free(void *ptr) {
+    return _syscall(SYS_free, ARG(ptr), 0, 0, 0, 0);
+}
+
+void *sys_realloc(void *ptr, uint64_t size) {
+    return (void *)_syscall(SYS_realloc, ARG(ptr), size, 0, 0, 0);
+}
+
+void *sys_calloc(uint64_t count, uint64_t size) {
+    return (void *)_syscall(SYS_calloc, count, size, 0, 0, 0);
+}
+
+int32_t sys_get_syscall_stats(SyscallStats * stats, uint32_t maxEntries) {
+    return _syscall(SYS_get_syscall_stats, ARG(stats), maxEntries, 0, 0, 0);
+}
+
+pid_t sys_create_process(const char * name, ProcessEntry entry, uint64_t argc, char * argv[]) {
+    return _syscall(SYS_create_process, ARG(name), ARG(entry), argc, ARG(argv), 0);
+}
+
+pid_t sys_getpid(void) {
+    return _syscall(SYS_getpid, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_yield(void) {
+    return _syscall(SYS_yield, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_kill(pid_t pid) {
+    return _syscall(SYS_kill, pid, 0, 0, 0, 0);
+}
+
+pid_t sys_waitpid(pid_t pid, int64_t * status) {
+    return _syscall(SYS_waitpid, pid, ARG(status), 0, 0, 0);
+}
+
+int32_t sys_block(pid_t pid) {
+    return _syscall(SYS_block, pid, 0, 0, 0, 0);
+}
+
+int32_t sys_unblock(pid_t pid) {
+    return _syscall(SYS_unblock, pid, 0, 0, 0, 0);
+}
+
+int32_t sys_nice(pid_t pid, uint8_t priority) {
+    return _syscall(SYS_nice, pid, priority, 0, 0, 0);
+}
+
+int32_t sys_get_processes(ProcessInfo * info, uint32_t maxEntries) {
+    return _syscall(SYS_get_processes, ARG(info), maxEntries, 0, 0, 0);
+}
+
+int32_t sys_exit(int64_t code) {
+    return _syscall(SYS_exit, code, 0, 0, 0, 0);
+}
+
+uint64_t sys_context_switches(void) {
+    return _syscall(SYS_context_switches, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_sem_open(const char * name, uint32_t initialValue) {
+    return _syscall(SYS_sem_open, ARG(name), initialValue, 0, 0, 0);
+}
+
+int32_t sys_sem_wait(int32_t id) {
+    return _syscall(SYS_sem_wait, id, 0, 0, 0, 0);
+}
+
+int32_t sys_sem_post(int32_t id) {
+    return _syscall(SYS_sem_post, id, 0, 0, 0, 0);
+}
+
+int32_t sys_sem_close(int32_t id) {
+    return _syscall(SYS_sem_close, id, 0, 0, 0, 0);
+}
+
+int32_t sys_pipe(int32_t fds[2]) {
+    return _syscall(SYS_pipe, ARG(fds), 0, 0, 0, 0);
+}
+
+int32_t sys_close(int32_t fd) {
+    return _syscall(SYS_close, fd, 0, 0, 0, 0);
+}
+
+int32_t sys_dup(int32_t fd) {
+    return _syscall(SYS_dup, fd, 0, 0, 0, 0);
+}
+
+int32_t sys_dup2(int32_t fd, int32_t target) {
+    return _syscall(SYS_dup2, fd, target, 0, 0, 0);
+}
+
+int32_t sys_open(const char * name) {
+    return _syscall(SYS_open, ARG(name), 0, 0, 0, 0);
+}
+
+int32_t sys_clock_gettime(uint32_t clockId, Timespec * ts) {
+    return _syscall(SYS_clock_gettime, clockId, ARG(ts), 0, 0, 0);
+}
+
+int32_t sys_get_interrupt_stats(InterruptStats * stats) {
+    return _syscall(SYS_get_interrupt_stats, ARG(stats), 0, 0, 0, 0);
+}
+
+int32_t sys_set_irq_affinity(uint8_t irq, uint8_t apicId) {
+    return _syscall(SYS_set_irq_affinity, irq, apicId, 0, 0, 0);
+}
+
+int32_t sys_get_cpu_stats(CpuInfo * info, uint32_t maxEntries) {
+    return _syscall(SYS_get_cpu_stats, ARG(info), maxEntries, 0, 0, 0);
+}
+
+int32_t sys_get_lock_stats(LockInfo * info, uint32_t maxEntries) {
+    return _syscall(SYS_get_lock_stats, ARG(info), maxEntries, 0, 0, 0);
+}
+
+int32_t sys_flush_video(void) {
+    return _syscall(SYS_flush_video, 0, 0, 0, 0, 0);
+}
+
+int32_t sys_register_robust_lock(volatile pid_t * lock) {
+    return _syscall(SYS_register_robust_lock, ARG(lock), 0, 0, 0, 0);
+}
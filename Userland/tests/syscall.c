@@ -0,0 +1,145 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys.h>
+#include "syscall.h"
+#include "test_util.h"
+
+// Adapters between the test suite's my_* API and libsys.
+// Processes are created by name, so the tests only name the programs below.
+
+typedef struct {
+  char *name;
+  ProcessEntry entry;
+} TestProgram;
+
+static int64_t endless_loop_main(uint64_t argc, char *argv[]) {
+  endless_loop();
+  return 0;
+}
+
+static int64_t endless_loop_print_main(uint64_t argc, char *argv[]) {
+  endless_loop_print(argc > 0 ? satoi(argv[0]) : 0);
+  return 0;
+}
+
+// test_sync.c
+uint64_t my_process_inc(uint64_t argc, char *argv[]);
+
+static TestProgram programs[] = {
+    {"endless_loop", endless_loop_main},
+    {"endless_loop_print", endless_loop_print_main},
+    {"my_process_inc", (ProcessEntry)my_process_inc},
+};
+
+int64_t my_getpid() {
+  return getpid();
+}
+
+int64_t my_create_process(char *name, uint64_t argc, char *argv[]) {
+  for (uint32_t i = 0; i < sizeof(programs) / sizeof(*programs); i++)
+    if (strcmp(programs[i].name, name) == 0)
+      return createProcess(name, programs[i].entry, argc, argv);
+  return -1;
+}
+
+int64_t my_nice(uint64_t pid, uint64_t newPrio) {
+  return nice(pid, newPrio);
+}
+
+int64_t my_ticks(int64_t pid) {
+  static ProcessInfo info[MAX_PROCESSES];
+  int32_t count = getProcesses(info, MAX_PROCESSES);
+  for (int32_t i = 0; i < count; i++)
+    if (info[i].pid == pid)
+      return info[i].ticks;
+  return -1;
+}
+
+// The tests never wait for what they kill, so the zombie is collected right away
+int64_t my_kill(uint64_t pid) {
+  if (killProcess(pid) == -1)
+    return -1;
+  waitpid(pid, NULL);
+  return 0;
+}
+
+int64_t my_cpu_stats(CpuInfo *info, uint64_t max) {
+  return getCpuStats(info, max);
+}
+
+int64_t my_block(uint64_t pid) {
+  return blockProcess(pid);
+}
+
+int64_t my_unblock(uint64_t pid) {
+  return unblockProcess(pid);
+}
+
+// The tests name semaphores on every call while the kernel works with ids,
+// so opened names are remembered here. While a name is open it always maps
+// to the same id, so a duplicate entry left by two processes opening at once
+// is harmless; the id is refreshed on every open in case it was recreated.
+#define MAX_TEST_SEMAPHORES 16
+
+static struct {
+  char *name;
+  int32_t id;
+} openSemaphores[MAX_TEST_SEMAPHORES];
+static uint32_t openCount = 0;
+
+static int32_t findSemaphore(char *name) {
+  for (uint32_t i = 0; i < openCount && i < MAX_TEST_SEMAPHORES; i++) {
+    char *entry = __atomic_load_n(&openSemaphores[i].name, __ATOMIC_ACQUIRE);
+    if (entry && strcmp(entry, name) == 0)
+      return i;
+  }
+  return -1;
+}
+
+static int32_t semaphoreId(char *name) {
+  int32_t i = findSemaphore(name);
+  return i == -1 ? -1 : openSemaphores[i].id;
+}
+
+// Returns non-zero on success, as the tests expect
+int64_t my_sem_open(char *sem_id, uint64_t initialValue) {
+  int32_t id = semOpen(sem_id, initialValue);
+  if (id == -1)
+    return 0;
+
+  int32_t i = findSemaphore(sem_id);
+  if (i != -1) {
+    openSemaphores[i].id = id;
+  } else {
+    uint32_t slot = __atomic_fetch_add(&openCount, 1, __ATOMIC_RELAXED);
+    if (slot >= MAX_TEST_SEMAPHORES) {
+      semClose(id);
+      return 0;
+    }
+    openSemaphores[slot].id = id;
+    __atomic_store_n(&openSemaphores[slot].name, sem_id, __ATOMIC_RELEASE);
+  }
+  return 1;
+}
+
+int64_t my_sem_wait(char *sem_id) {
+  return semWait(semaphoreId(sem_id));
+}
+
+int64_t my_sem_post(char *sem_id) {
+  return semPost(semaphoreId(sem_id));
+}
+
+int64_t my_sem_close(char *sem_id) {
+  return semClose(semaphoreId(sem_id));
+}
+
+int64_t my_yield() {
+  yield();
+  return 0;
+}
+
+int64_t my_wait(int64_t pid) {
+  return waitpid(pid, NULL);
+}
@@ -0,0 +1,17 @@
+#include <stdint.h>
+#include <cpuInfo.h>
+
+int64_t my_getpid();
+int64_t my_create_process(char *name, uint64_t argc, char *argv[]);
+int64_t my_nice(uint64_t pid, uint64_t newPrio);
+int64_t my_kill(uint64_t pid);
+int64_t my_block(uint64_t pid);
+int64_t my_unblock(uint64_t pid);
+int64_t my_sem_open(char *sem_id, uint64_t initialValue);
+int64_t my_sem_wait(char *sem_id);
+int64_t my_sem_post(char *sem_id);
+int64_t my_sem_close(char *sem_id);
+int64_t my_yield();
+int64_t my_wait(int64_t pid);
+int64_t my_ticks(int64_t pid); // timer ticks the process has run for
+int64_t my_cpu_stats(CpuInfo *info, uint64_t max); // returns the number of CPUs filled in
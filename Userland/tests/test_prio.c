@@ -1,63 +1,60 @@
-// //TODO
-// //ESTE TEST NO ESTA ACTUALIZADO CON EL ENUNCIADO 2C-2025
-// //EN UNOS DIAS LO ACTUALIZO Y AVISO
+#include <stdint.h>
+#include <stdio.h>
+#include <processInfo.h>
+#include "syscall.h"
+#include "test_util.h"
 
-// //DEPRECATED
-// //DEPRECATED
-// //DEPRECATED
-// //DEPRECATED
-// //DEPRECATED
-// //DEPRECATED
-// //DEPRECATED
+#define MINOR_WAIT "1000000" // Passed to endless_loop_print, keeps each process from flooding the screen
+#define WAIT 100000000       // Long enough to see these processes being run several times
 
-// #include <stdint.h>
-// #include <stdio.h>
-// #include "syscall.h"
-// #include "test_util.h"
+#define TOTAL_PROCESSES 3
+#define LOWEST PRIORITY_LOWEST
+#define MEDIUM PRIORITY_DEFAULT
+#define HIGHEST PRIORITY_HIGHEST
 
-// #define MINOR_WAIT 1000000 // TODO: Change this value to prevent a process from flooding the screen
-// #define WAIT 10000000      // TODO: Change this value to make the wait long enough to see theese processes beeing run at least twice
+int64_t prio[TOTAL_PROCESSES] = {LOWEST, MEDIUM, HIGHEST};
 
-// #define TOTAL_PROCESSES 3
-// #define LOWEST 0  // TODO: Change as required
-// #define MEDIUM 1  // TODO: Change as required
-// #define HIGHEST 2 // TODO: Change as required
+void test_prio() {
+  int64_t pids[TOTAL_PROCESSES];
+  int64_t ticks[TOTAL_PROCESSES];
+  char *argv[] = {MINOR_WAIT};
+  uint64_t i;
 
-// int64_t prio[TOTAL_PROCESSES] = {LOWEST, MEDIUM, HIGHEST};
+  for (i = 0; i < TOTAL_PROCESSES; i++)
+    pids[i] = my_create_process("endless_loop_print", 1, argv);
 
-// void test_prio() {
-//   int64_t pids[TOTAL_PROCESSES];
-//   char *argv[] = {0};
-//   uint64_t i;
+  bussy_wait(WAIT);
+  printf("\nCHANGING PRIORITIES...\n");
 
-//   for (i = 0; i < TOTAL_PROCESSES; i++)
-//     pids[i] = my_create_process("endless_loop_print", 0, argv);
+  for (i = 0; i < TOTAL_PROCESSES; i++) {
+    my_nice(pids[i], prio[i]);
+    ticks[i] = my_ticks(pids[i]);
+  }
 
-//   bussy_wait(WAIT);
-//   printf("\nCHANGING PRIORITIES...\n");
+  bussy_wait(WAIT);
 
-//   for (i = 0; i < TOTAL_PROCESSES; i++)
-//     my_nice(pids[i], prio[i]);
+  printf("\nTICKS RUN SINCE CHANGING PRIORITIES:\n");
+  for (i = 0; i < TOTAL_PROCESSES; i++)
+    printf("  pid %d priority %d: %d\n", (int)pids[i], (int)prio[i], (int)(my_ticks(pids[i]) - ticks[i]));
 
-//   bussy_wait(WAIT);
-//   printf("\nBLOCKING...\n");
+  printf("BLOCKING...\n");
 
-//   for (i = 0; i < TOTAL_PROCESSES; i++)
-//     my_block(pids[i]);
+  for (i = 0; i < TOTAL_PROCESSES; i++)
+    my_block(pids[i]);
 
-//   printf("CHANGING PRIORITIES WHILE BLOCKED...\n");
+  printf("CHANGING PRIORITIES WHILE BLOCKED...\n");
 
-//   for (i = 0; i < TOTAL_PROCESSES; i++)
-//     my_nice(pids[i], MEDIUM);
+  for (i = 0; i < TOTAL_PROCESSES; i++)
+    my_nice(pids[i], MEDIUM);
 
-//   printf("UNBLOCKING...\n");
+  printf("UNBLOCKING...\n");
 
-//   for (i = 0; i < TOTAL_PROCESSES; i++)
-//     my_unblock(pids[i]);
+  for (i = 0; i < TOTAL_PROCESSES; i++)
+    my_unblock(pids[i]);
 
-//   bussy_wait(WAIT);
-//   printf("\nKILLING...\n");
+  bussy_wait(WAIT);
+  printf("\nKILLING...\n");
 
-//   for (i = 0; i < TOTAL_PROCESSES; i++)
-//     my_kill(pids[i]);
-// }
+  for (i = 0; i < TOTAL_PROCESSES; i++)
+    my_kill(pids[i]);
+}
@@ -0,0 +1,70 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <cpuInfo.h>
+#include "syscall.h"
+#include "test_util.h"
+
+#define MAX_TEST_PROCESSES 64
+#define WAIT 100000000 // Long enough for every CPU to go through many quanta
+#define MIN_BUSY_PERCENT 90
+
+// Runs more endless_loop processes than there are CPUs and checks that the
+// run queues keep every CPU busy and every process running.
+int64_t test_smp(uint64_t argc, char *argv[]) {
+  static CpuInfo before[MAX_CPUS], after[MAX_CPUS];
+  int64_t pids[MAX_TEST_PROCESSES];
+  char *argvAux[] = {0};
+  int64_t result = 0;
+  uint64_t processes;
+  int64_t cpus;
+  uint64_t i;
+
+  if ((cpus = my_cpu_stats(before, MAX_CPUS)) <= 0)
+    return -1;
+
+  processes = argc > 0 ? satoi(argv[0]) : 4 * cpus;
+  if (processes <= 0 || processes > MAX_TEST_PROCESSES)
+    return -1;
+
+  for (i = 0; i < processes; i++) {
+    pids[i] = my_create_process("endless_loop", 0, argvAux);
+    if (pids[i] == -1) {
+      printf("test_smp: ERROR creating process\n");
+      processes = i;
+      result = -1;
+      break;
+    }
+  }
+
+  if (result == 0) {
+    my_cpu_stats(before, MAX_CPUS);
+    bussy_wait(WAIT);
+    my_cpu_stats(after, MAX_CPUS);
+
+    printf("%d processes on %d CPUs:\n", (int)processes, (int)cpus);
+    for (i = 0; i < cpus; i++) {
+      uint64_t busy = after[i].busyTicks - before[i].busyTicks;
+      uint64_t total = busy + after[i].idleTicks - before[i].idleTicks;
+      uint64_t percent = total ? busy * 100 / total : 0;
+      printf("  CPU %d: %d%% busy, %d queued at most, %d stolen from others, %d stolen by others\n", (int)i, (int)percent,
+             (int)after[i].maxQueued, (int)(after[i].steals - before[i].steals), (int)(after[i].stolen - before[i].stolen));
+      if (processes >= cpus && percent < MIN_BUSY_PERCENT) {
+        printf("test_smp: ERROR CPU %d was idle with processes ready\n", (int)i);
+        result = -1;
+      }
+    }
+
+    for (i = 0; i < processes; i++)
+      if (my_ticks(pids[i]) <= 0) {
+        printf("test_smp: ERROR process %d never ran\n", (int)pids[i]);
+        result = -1;
+      }
+  }
+
+  for (i = 0; i < processes; i++)
+    my_kill(pids[i]);
+
+  if (result == 0)
+    printf("test_smp: OK\n");
+  return result;
+}
@@ -1,5 +1,6 @@
 #include <stdint.h>
 #include <stdio.h>
+#include "syscall.h"
 
 
 // Random
@@ -64,11 +65,11 @@ void endless_loop() {
     ;
 }
 
-// void endless_loop_print(uint64_t wait) {
-//   int64_t pid = my_getpid();
+void endless_loop_print(uint64_t wait) {
+  int64_t pid = my_getpid();
 
-//   while (1) {
-//     printf("%d ", pid);
-//     bussy_wait(wait);
-//   }
-// }
+  while (1) {
+    printf("%d ", pid);
+    bussy_wait(wait);
+  }
+}
@@ -1,6 +1,6 @@
 #!/bin/bash
 # Validates the existance of the TPE-ARQ container, starts it up & compiles the project
-# Usage: ./compile.sh [naive|buddy|all]
+# Usage: ./compile.sh [naive|buddy|buddytree|segregated|all]
 CONTAINER_NAME="tp2-so"
 
 # Memory manager selection (default: all)
@@ -15,14 +15,16 @@ NC='\033[0m'
 
 # Validate memory manager parameter
 case "$MEMORY_MANAGER" in
-    naive|buddy|all)
+    naive|buddy|buddytree|segregated|all)
         echo "${BLUE}🔧 Selected memory manager: $MEMORY_MANAGER${NC}"
         ;;
     *)
         echo "${RED}❌ Invalid memory manager: $MEMORY_MANAGER${NC}"
-        echo "Usage: $0 [naive|buddy|all]"
+        echo "Usage: $0 [naive|buddy|buddytree|segregated|all]"
         echo "  naive - Compile with Naive Memory Manager"
         echo "  buddy - Compile with Buddy Memory Manager" 
+        echo "  buddytree - Compile with the legacy tree-walk Buddy (benchmark baseline)"
+        echo "  segregated - Compile with the Segregated-Fit (size class) Memory Manager"
         echo "  all   - Default compilation (naive by default)"
         exit 1
         ;;